@@ -0,0 +1,32 @@
+#include "benchmark.hpp"
+#include <fpp/core/AllocationTracker.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::int64_t> allocations { 0 };
+}
+
+std::int64_t allocation_count() {
+    return allocations;
+}
+
+void* operator new(std::size_t size) {
+    allocations++;
+#ifdef FPP_TRACK_ALLOCATIONS
+    fpp::AllocationTracker::instance().countHeapAllocation();
+#endif
+    if (const auto ptr { std::malloc(size ? size : 1) }) {
+        return ptr;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <fpp/base/Frame.hpp>
+#include <fpp/base/Parameters.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct BenchmarkResult {
+    std::string     name;
+    std::string     unit;
+    std::int64_t    items;
+    std::int64_t    elapsed_us;
+    std::int64_t    allocations;
+};
+
+using BenchmarkResults = std::vector<BenchmarkResult>;
+
+/* locally generated sources */
+constexpr auto bench_video_source { "testsrc2=duration=10:size=640x360:rate=30" };
+constexpr auto bench_audio_source { "sine=frequency=1000:sample_rate=44100:duration=10" };
+constexpr auto bench_video_file   { "fpp_bench_video.mkv" };
+
+/* heap allocations made through operator new since program start */
+std::int64_t allocation_count();
+
+struct DecodedVideo {
+    fpp::SpParameters   params;
+    fpp::FrameVector    frames;
+};
+
+void prepare_video_file();
+DecodedVideo decode_video_file(std::size_t max_frames);
+
+BenchmarkResult bench_remux();
+BenchmarkResult bench_decode();
+BenchmarkResult bench_encode();
+BenchmarkResult bench_rescale();
+BenchmarkResult bench_resample();
+BenchmarkResult bench_filter();
@@ -0,0 +1,30 @@
+CONFIG(debug, debug|release) {
+    TARGET = fpp_benchmarkd
+} else {
+    TARGET = fpp_benchmark
+}
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += D:\libs\ffmpeg\4.1.3\ffmpeg-4.1.3-win64-dev\include
+LIBS += -LD:\libs\ffmpeg\4.1.3\ffmpeg-4.1.3-win64-dev\lib
+
+LIBS += -lavcodec -lavdevice -lavfilter -lavformat -lavutil
+LIBS += -lpostproc -lswresample -lswscale
+
+include(../fpp/fpp.pri)
+
+SOURCES += \
+    allocation_counter.cpp \
+    codec.cpp \
+    filter.cpp \
+    input.cpp \
+    main.cpp \
+    remux.cpp \
+    resample.cpp \
+    rescale.cpp
+
+HEADERS += \
+    benchmark.hpp
@@ -0,0 +1,85 @@
+#include "benchmark.hpp"
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/codec/DecoderContext.hpp>
+#include <fpp/codec/EncoderContext.hpp>
+#include <fpp/stream/VideoParameters.hpp>
+#include <fpp/core/time/Chronometer.hpp>
+
+BenchmarkResult bench_decode() {
+
+    fpp::InputFormatContext source {
+        bench_video_file
+    };
+    if (!source.open()) {
+        throw std::runtime_error { "Failed to open benchmark video file" };
+    }
+
+    /* read packets beforehand to measure decoding only */
+    fpp::PacketVector packets;
+    for (auto packet { source.read() }; !packet.isEOF(); packet = source.read()) {
+        if (packet.isVideo()) {
+            packets.push_back(packet);
+        }
+    }
+    if (packets.empty()) {
+        throw std::runtime_error { "No video packets in benchmark video file" };
+    }
+
+    fpp::DecoderContext decoder {
+        source.stream(fpp::Media::Type::Video)->params
+    };
+
+    std::int64_t frames { 0 };
+    const auto allocations_before { allocation_count() };
+    fpp::Chronometer chronometer;
+
+    for (const auto& packet : packets) {
+        frames += std::int64_t(decoder.decode(packet).size());
+    }
+    frames += std::int64_t(decoder.flush(packets.front().timeBase(), packets.front().streamIndex()).size());
+
+    return {
+          "decode"
+        , "frames"
+        , frames
+        , chronometer.elapsed_microseconds().count()
+        , allocation_count() - allocations_before
+    };
+
+}
+
+BenchmarkResult bench_encode() {
+
+    auto [in_params, frames] { decode_video_file(150) };
+
+    const auto out_params { fpp::VideoParameters::make_shared() };
+    out_params->setEncoder(AVCodecID::AV_CODEC_ID_MPEG4);
+    out_params->setBitrate(2'000'000);
+    out_params->setGopSize(30);
+    out_params->completeFrom(in_params);
+
+    fpp::EncoderContext encoder { out_params };
+
+    /* stamp frames in encoder's time base (1/fps) */
+    for (std::size_t i { 0 }; i < frames.size(); ++i) {
+        frames[i].setPts(std::int64_t(i));
+    }
+
+    std::int64_t packets { 0 };
+    const auto allocations_before { allocation_count() };
+    fpp::Chronometer chronometer;
+
+    for (const auto& frame : frames) {
+        packets += std::int64_t(encoder.encode(frame).size());
+    }
+    packets += std::int64_t(encoder.flush(in_params->timeBase(), 0).size());
+
+    return {
+          "encode"
+        , "packets"
+        , packets
+        , chronometer.elapsed_microseconds().count()
+        , allocation_count() - allocations_before
+    };
+
+}
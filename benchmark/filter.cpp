@@ -0,0 +1,29 @@
+#include "benchmark.hpp"
+#include <fpp/filter/LinearFilterGraph.hpp>
+#include <fpp/core/time/Chronometer.hpp>
+
+BenchmarkResult bench_filter() {
+
+    const auto [params, frames] { decode_video_file(120) };
+
+    fpp::LinearFilterGraph filter_graph {
+          params
+        , { "hflip" }
+    };
+
+    const auto allocations_before { allocation_count() };
+    fpp::Chronometer chronometer;
+
+    for (const auto& frame : frames) {
+        filter_graph.filter(frame);
+    }
+
+    return {
+          "linear_filter_graph"
+        , "frames"
+        , std::int64_t(frames.size())
+        , chronometer.elapsed_microseconds().count()
+        , allocation_count() - allocations_before
+    };
+
+}
@@ -0,0 +1,91 @@
+#include "benchmark.hpp"
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/codec/DecoderContext.hpp>
+#include <fpp/codec/EncoderContext.hpp>
+#include <fpp/scale/RescaleContext.hpp>
+
+void prepare_video_file() {
+
+    /* create source */
+    fpp::InputFormatContext source {
+        bench_video_source
+    };
+
+    /* open source */
+    if (!source.open()) {
+        throw std::runtime_error { "Failed to open benchmark video source" };
+    }
+
+    /* create sink */
+    fpp::OutputFormatContext sink {
+        bench_video_file
+    };
+
+    /* create output params: mpeg4 is always built in */
+    const auto in_params { source.stream(fpp::Media::Type::Video)->params };
+    const auto out_params { fpp::VideoParameters::make_shared() };
+    out_params->setEncoder(AVCodecID::AV_CODEC_ID_MPEG4);
+    out_params->setPixelFormat(AVPixelFormat::AV_PIX_FMT_YUV420P);
+    out_params->setBitrate(2'000'000);
+    out_params->setGopSize(30);
+    out_params->completeFrom(in_params);
+    sink.createStream(out_params);
+
+    /* create codec contexts and rescaler */
+    fpp::DecoderContext decoder { in_params };
+    fpp::RescaleContext rescaler {{
+          in_params
+        , sink.stream(fpp::Media::Type::Video)->params
+    }};
+    fpp::EncoderContext encoder {
+        sink.stream(fpp::Media::Type::Video)->params
+    };
+
+    /* open sink */
+    if (!sink.open()) {
+        throw std::runtime_error { "Failed to open benchmark video file" };
+    }
+
+    const auto write_packets {
+        [&sink](fpp::PacketVector packets) {
+            for (auto& packet : packets) {
+                sink.write(packet);
+            }
+        }
+    };
+
+    /* read, transcode and write packets */
+    for (auto packet { source.read() }; !packet.isEOF(); packet = source.read()) {
+        for (const auto& frame : decoder.decode(packet)) {
+            write_packets(encoder.encode(rescaler.scale(frame)));
+        }
+    }
+    write_packets(encoder.flush(in_params->timeBase(), 0));
+
+}
+
+DecodedVideo decode_video_file(std::size_t max_frames) {
+
+    fpp::InputFormatContext source {
+        bench_video_file
+    };
+    if (!source.open()) {
+        throw std::runtime_error { "Failed to open benchmark video file" };
+    }
+
+    const auto params { source.stream(fpp::Media::Type::Video)->params };
+    fpp::DecoderContext decoder { params };
+
+    DecodedVideo result { params, {} };
+    for (auto packet { source.read() }; !packet.isEOF(); packet = source.read()) {
+        for (const auto& frame : decoder.decode(packet)) {
+            if (result.frames.size() == max_frames) {
+                return result;
+            }
+            result.frames.push_back(frame);
+        }
+    }
+    return result;
+
+}
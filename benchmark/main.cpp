@@ -0,0 +1,97 @@
+#include "benchmark.hpp"
+#include <fpp/core/AllocationTracker.hpp>
+#include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/Logger.hpp>
+#include <fpp/core/Utils.hpp>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+std::string to_json(const BenchmarkResult& result) {
+    const auto seconds {
+        double(result.elapsed_us) / 1'000'000
+    };
+    const auto per_second {
+        result.elapsed_us ? double(result.items) / seconds : 0.0
+    };
+    const auto allocations_per_item {
+        result.items ? double(result.allocations) / double(result.items) : 0.0
+    };
+    std::stringstream ss;
+    ss << "{ "
+       << "\"name\": "                 << std::quoted(result.name) << ", "
+       << "\"unit\": "                 << std::quoted(result.unit) << ", "
+       << "\"items\": "                << result.items             << ", "
+       << "\"seconds\": "              << seconds                  << ", "
+       << "\"per_second\": "           << per_second               << ", "
+       << "\"allocations\": "          << result.allocations       << ", "
+       << "\"allocations_per_item\": " << allocations_per_item
+       << " }";
+    return ss.str();
+}
+
+std::string to_json(const BenchmarkResults& results) {
+    std::stringstream ss;
+    ss << "{\n"
+       << "  \"ffmpeg_version\": " << std::quoted(fpp::utils::ffmpeg_version()) << ",\n"
+       << "  \"benchmarks\": [";
+    for (std::size_t i { 0 }; i < results.size(); ++i) {
+        ss << (i ? ",\n" : "\n") << "    " << to_json(results[i]);
+    }
+    ss << "\n  ]\n}\n";
+    return ss.str();
+}
+
+} // namespace
+
+/* usage: fpp_benchmark [output.json] */
+auto main(int argc, char* argv[]) -> int {
+
+    /* keep stdout clean for the json report */
+    fpp::Logger::instance().setPrintCallback(
+        [](fpp::LogLevel, const std::string& message) {
+            std::cerr << message << '\n';
+        }
+    );
+    fpp::set_log_level(fpp::LogLevel::Error);
+    fpp::set_ffmpeg_log_level(fpp::LogLevel::Error);
+
+    BenchmarkResults results;
+
+    try {
+        prepare_video_file();
+#ifdef FPP_TRACK_ALLOCATIONS
+        fpp::AllocationTracker::instance().reset();
+#endif
+        results.push_back(bench_remux());
+        results.push_back(bench_decode());
+        results.push_back(bench_encode());
+        results.push_back(bench_rescale());
+        results.push_back(bench_resample());
+        results.push_back(bench_filter());
+    } catch (const fpp::FFmpegException& e) {
+        fpp::static_log_error() << "FFmpegException:" << e.what();
+        return 1;
+    } catch (const std::exception& e) {
+        fpp::static_log_error() << "Exception:" << e.what();
+        return 1;
+    }
+
+#ifdef FPP_TRACK_ALLOCATIONS
+    std::cerr << "Allocations per stage:\n"
+              << fpp::AllocationTracker::instance().report();
+#endif
+
+    const auto report { to_json(results) };
+    if (argc > 1) {
+        std::ofstream { argv[1] } << report;
+    } else {
+        std::cout << report;
+    }
+
+    return 0;
+
+}
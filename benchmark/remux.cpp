@@ -0,0 +1,42 @@
+#include "benchmark.hpp"
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/core/time/Chronometer.hpp>
+
+BenchmarkResult bench_remux() {
+
+    fpp::InputFormatContext source {
+        bench_video_file
+    };
+    if (!source.open()) {
+        throw std::runtime_error { "Failed to open benchmark video file" };
+    }
+
+    fpp::OutputFormatContext sink {
+        "fpp_bench_remux.mkv"
+    };
+    for (const auto& input_stream : source.streams()) {
+        sink.copyStream(input_stream);
+    }
+    if (!sink.open()) {
+        throw std::runtime_error { "Failed to open remux sink" };
+    }
+
+    std::int64_t packets { 0 };
+    const auto allocations_before { allocation_count() };
+    fpp::Chronometer chronometer;
+
+    for (auto packet { source.read() }; !packet.isEOF(); packet = source.read()) {
+        sink.write(packet);
+        ++packets;
+    }
+
+    return {
+          "remux"
+        , "packets"
+        , packets
+        , chronometer.elapsed_microseconds().count()
+        , allocation_count() - allocations_before
+    };
+
+}
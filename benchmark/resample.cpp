@@ -0,0 +1,54 @@
+#include "benchmark.hpp"
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/codec/DecoderContext.hpp>
+#include <fpp/resample/ResampleContext.hpp>
+#include <fpp/core/time/Chronometer.hpp>
+
+BenchmarkResult bench_resample() {
+
+    fpp::InputFormatContext source {
+        bench_audio_source
+    };
+    if (!source.open()) {
+        throw std::runtime_error { "Failed to open benchmark audio source" };
+    }
+
+    const auto in_params { source.stream(fpp::Media::Type::Audio)->params };
+    fpp::DecoderContext decoder { in_params };
+
+    fpp::FrameVector frames;
+    for (auto packet { source.read() }; !packet.isEOF(); packet = source.read()) {
+        for (const auto& frame : decoder.decode(packet)) {
+            frames.push_back(frame);
+        }
+    }
+
+    /* 44.1 kHz mono -> 48 kHz stereo fltp, aac sized frames */
+    const auto out_params { fpp::AudioParameters::make_shared() };
+    out_params->setSampleRate(48'000);
+    out_params->setSampleFormat(AVSampleFormat::AV_SAMPLE_FMT_FLTP);
+    out_params->setChannelLayout(AV_CH_LAYOUT_STEREO);
+    out_params->setChannels(2);
+    out_params->setFrameSize(1024);
+    out_params->completeFrom(in_params);
+
+    fpp::ResampleContext resampler {{ in_params, out_params }};
+
+    std::int64_t samples { 0 };
+    const auto allocations_before { allocation_count() };
+    fpp::Chronometer chronometer;
+
+    for (const auto& frame : frames) {
+        resampler.resample(frame);
+        samples += frame.nbSamples();
+    }
+
+    return {
+          "resample"
+        , "samples"
+        , samples
+        , chronometer.elapsed_microseconds().count()
+        , allocation_count() - allocations_before
+    };
+
+}
@@ -0,0 +1,32 @@
+#include "benchmark.hpp"
+#include <fpp/scale/RescaleContext.hpp>
+#include <fpp/core/time/Chronometer.hpp>
+
+BenchmarkResult bench_rescale() {
+
+    const auto [in_params, frames] { decode_video_file(120) };
+
+    /* 640x360 -> 1280x720 */
+    const auto out_params { fpp::VideoParameters::make_shared() };
+    out_params->setWidth(1280);
+    out_params->setHeight(720);
+    out_params->completeFrom(in_params);
+
+    fpp::RescaleContext rescaler {{ in_params, out_params }};
+
+    const auto allocations_before { allocation_count() };
+    fpp::Chronometer chronometer;
+
+    for (const auto& frame : frames) {
+        rescaler.scale(frame);
+    }
+
+    return {
+          "rescale"
+        , "frames"
+        , std::int64_t(frames.size())
+        , chronometer.elapsed_microseconds().count()
+        , allocation_count() - allocations_before
+    };
+
+}
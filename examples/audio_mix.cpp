@@ -0,0 +1,109 @@
+#include "examples.hpp"
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/codec/DecoderContext.hpp>
+#include <fpp/codec/EncoderContext.hpp>
+#include <fpp/resample/ResampleContext.hpp>
+#include <fpp/pipeline/AudioMixer.hpp>
+#include <array>
+
+void audio_mix() {
+
+    /* create sources */
+    constexpr auto N { 3 };
+    std::array<fpp::InputFormatContext,N> sources {
+          fpp::InputFormatContext { "audio_0.mp3" }
+        , fpp::InputFormatContext { "audio_1.mp3" }
+        , fpp::InputFormatContext { "audio_2.mp3" }
+    };
+
+    /* open sources */
+    for (auto& src : sources) {
+        if (!src.open()) {
+            return;
+        }
+    }
+
+    /* create output params based on 1st source's params,
+     * mixer works with planar float */
+    const auto inpar {
+        sources[0].stream(fpp::Media::Type::Audio)->params
+    };
+    const auto outpar {
+        fpp::AudioParameters::make_shared()
+    };
+    outpar->setSampleFormat(AVSampleFormat::AV_SAMPLE_FMT_FLTP);
+    outpar->completeFrom(inpar);
+
+    /* create sink */
+    fpp::OutputFormatContext sink {
+        "mixed_audio.mp3"
+    };
+
+    /* create output stream */
+    sink.createStream(outpar);
+
+    /* create codecs, resamplers bring every input to the mixer's format */
+    std::array<fpp::DecoderContext,N> decoders {
+          fpp::DecoderContext { sources[0].stream(fpp::Media::Type::Audio)->params }
+        , fpp::DecoderContext { sources[1].stream(fpp::Media::Type::Audio)->params }
+        , fpp::DecoderContext { sources[2].stream(fpp::Media::Type::Audio)->params }
+    };
+    std::array<fpp::ResampleContext,N> resamplers {
+          fpp::ResampleContext {{ sources[0].stream(fpp::Media::Type::Audio)->params, outpar }}
+        , fpp::ResampleContext {{ sources[1].stream(fpp::Media::Type::Audio)->params, outpar }}
+        , fpp::ResampleContext {{ sources[2].stream(fpp::Media::Type::Audio)->params, outpar }}
+    };
+    fpp::EncoderContext encoder { outpar };
+
+    /* same mix as the complex filter graph example:
+     * adelay=1000, adelay=2000 + volume=1, volume=3 */
+    fpp::AudioMixer mixer { outpar };
+    const std::array<std::size_t,N> input_index {
+          mixer.addInput(1.f, 1000)
+        , mixer.addInput(1.f, 2000)
+        , mixer.addInput(3.f)
+    };
+
+    /* open sink */
+    if (!sink.open()) {
+        return;
+    }
+
+    const auto write {
+        [&](const fpp::FrameVector& frames) {
+            for (const auto& frame  : frames)                {
+            for (auto& packet       : encoder.encode(frame)) {
+                packet.setStreamIndex(0);
+                sink.write(packet);
+            }}
+        }
+    };
+
+    /* read, decode, resample and mix */
+    auto all_empty { false };
+    while (!all_empty) {
+        all_empty = true;
+        for (std::size_t i { 0 }; i < sources.size(); ++i) {
+            const auto packet { sources[i].read() };
+            if (packet.isEOF()) {
+                mixer.finish(input_index[i]);
+                continue;
+            }
+            all_empty = false;
+            for (const auto& frame   : decoders[i].decode(packet))   {
+            for (const auto& r_frame : resamplers[i].resample(frame)) {
+                mixer.push(input_index[i], r_frame);
+            }}
+        }
+        write(mixer.mix());
+    }
+    write(mixer.flush());
+
+    /* explicitly close contexts */
+    for (auto& src : sources) {
+        src.close();
+    }
+    sink.close();
+
+}
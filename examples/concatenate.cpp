@@ -1,50 +1,20 @@
 #include "examples.hpp"
-#include <fpp/format/InputFormatContext.hpp>
 #include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/pipeline/Concatenator.hpp>
 
-void concatenate() { // TODO doesn't work 15.04
-
-    /* create source */
-    fpp::InputFormatContext source {
-//        "concat:file0.flv|file1.flv"
-        "mylist.txt"
-    };
-
-    /* open source */
-    if (!source.open()) {
-        return;
-    }
+void concatenate() {
 
     /* create sink */
     fpp::OutputFormatContext sink {
-        "con.avi"
+        "concatenated.flv"
     };
 
-    /* copy source's streams to sink */
-    for (const auto& input_stream : source.streams()) {
-        sink.copyStream(input_stream);
-    }
-
-    /* open sink */
-    if (!sink.open()) {
-        return;
-    }
-
-    fpp::Packet packet;
-    const auto read_packet {
-        [&packet,&source]() {
-            packet = source.read();
-            return !packet.isEOF();
-        }
+    /* segments must have the same streams and codec parameters */
+    fpp::Concatenator concatenator {
+        { "file0.flv", "file1.flv", "file2.flv" }, sink
     };
 
-    /* read and write packets */
-    while (read_packet()) {
-        sink.write(packet);
-    }
-
-    /* explicitly close contexts */
-    source.close();
-    sink.close();
+    /* stream copy without re-encoding */
+    concatenator.concatenate();
 
 }
@@ -32,3 +32,10 @@ void complex();
 void concatenate();
 void multiple_outputs_sequence();
 void multiple_outputs_parallel();
+void thumbnails();
+void segment_transcoding();
+void trimming();
+void keyframe_preview();
+void audio_mix();
+void mosaic();
+void remuxing();
@@ -5,6 +5,7 @@
 #include <fpp/codec/EncoderContext.hpp>
 #include <fpp/stream/AudioParameters.hpp>
 #include <fpp/filter/ComplexFilterGraph.hpp>
+#include <fpp/filter/FrameSynchronizer.hpp>
 #include <array>
 
 void complex() {
@@ -42,10 +43,10 @@ void complex() {
     fpp::EncoderContext encoder { outpar };
 
     /* create filter graph with 3 input chains and 1 output */
-    const fpp::Options graph_opt {
-        { "threads", "1" }
+    const fpp::FilterThreading graph_threading {
+        fpp::FilterThreading::Mode::None
     };
-    fpp::ComplexFilterGraph graph { graph_opt };
+    fpp::ComplexFilterGraph graph { graph_threading };
     const std::array<std::size_t, N> input_chain_index {
           graph.createInputFilterChain(sources[0].stream(fpp::Media::Type::Audio)->params, { "adelay=1000" })
         , graph.createInputFilterChain(sources[1].stream(fpp::Media::Type::Audio)->params, { "adelay=2000", "volume=1" })
@@ -70,31 +71,35 @@ void complex() {
         return;
     }
 
-    /* read and write packet */
-    while (true) {
+    /* feeds the graph in timestamp order, at most 500 ms of skew */
+    fpp::FrameSynchronizer synchronizer {
+        graph, { input_chain_index[0], input_chain_index[1], input_chain_index[2] }
+    };
 
-        auto all_empty { true };
-        for (std::size_t i { 0 }; i < sources.size(); ++i) {
-            const auto packet { sources[i].read() };
-            if (!packet.isEOF()) {
-                all_empty = false;
+    const auto write_filtered {
+        [&]() {
+            for (const auto& fa_frame : graph.read(output_chain_index)) {
+            for (/*const*/ auto& a_packet : encoder.encode(fa_frame))   {
+                a_packet.setStreamIndex(0);
+                a_packet.setTimeBase(inpar->timeBase());
+                sink.write(a_packet);
+            }}
+        }
+    };
 
-                for (const auto& a_frame  : decoders[i].decode(packet))     {
-                graph.write(a_frame, input_chain_index[i]);
-                for (const auto& fa_frame : graph.read(output_chain_index)) {
-                for (/*const*/ auto& a_packet : encoder.encode(fa_frame))   {
-                    a_packet.setStreamIndex(0);
-                    a_packet.setTimeBase(inpar->timeBase());
-                    sink.write(a_packet);
-                }}}
-            }
-            else {
-                continue;
-            }
+    /* read the source that is furthest behind */
+    while (!synchronizer.finished()) {
+        const auto i { synchronizer.nextInput() };
+        const auto packet { sources[i].read() };
+        if (packet.isEOF()) {
+            synchronizer.finish(i);
         }
-        if (all_empty) {
-            break;
+        else {
+            for (const auto& a_frame : decoders[i].decode(packet)) {
+                synchronizer.push(i, a_frame);
+            }
         }
+        write_filtered();
     }
 
     /* explicitly close contexts */
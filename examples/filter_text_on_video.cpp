@@ -62,13 +62,18 @@ void text_on_video() {
                 , "red"         /* color */
                 , ""            /* fontcolor_expr */
             }
+            , fpp::VideoFilter::DrawText::Box {}
+            , fpp::VideoFilter::DrawText::Shadow {}
+            , fpp::VideoFilter::DrawText::Time {}
+            , "counter"         /* instance name */
         )
     };
 
-    /* create filter */
+    /* create filter, slice jobs run on the shared thread pool */
     fpp::LinearFilterGraph filter_graph {
         source.stream(fpp::Media::Type::Video)->params
         , { draw_text }
+        , fpp::FilterThreading { fpp::FilterThreading::Mode::SharedPool }
     };
 
     /* open sink */
@@ -89,13 +94,23 @@ void text_on_video() {
     };
 
     /* read and write packets */
+    auto video_packets { 0 };
     while (read_packet()) {
         if (packet.isVideo()) {
-            for (const auto& v_frame  : video_decoder.decode(packet))  {
-            for (const auto& f_frame  : filter_graph.filter(v_frame))  {
+            /* update the text in place, no graph rebuild */
+            if (++video_packets % 25 == 0) {
+                const auto update {
+                    fpp::VideoFilter::DrawText::setText(
+                        "counter", "Packets: " + std::to_string(video_packets)
+                    )
+                };
+                filter_graph.sendCommand(update.target, update.command, update.arg);
+            }
+            /* decoded frames are moved into the graph, no extra refs */
+            for (const auto& f_frame  : filter_graph.filter(video_decoder.decode(packet))) {
             for (      auto& v_packet : video_encoder.encode(f_frame)) {
                 sink.write(v_packet);
-            }}}
+            }}
         }
     }
 
@@ -0,0 +1,55 @@
+#include "examples.hpp"
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/pipeline/KeyframePassthrough.hpp>
+
+void keyframe_preview() {
+
+    /* create source */
+    fpp::InputFormatContext source {
+        "rtsp://213.129.131.54/live/ch00_0"
+    };
+
+    /* open source */
+    if (!source.open()) {
+        return;
+    }
+
+    /* create sink */
+    fpp::OutputFormatContext sink {
+        "preview.mkv"
+    };
+
+    /* one keyframe per two seconds, no decoding */
+    fpp::KeyframePassthrough preview {
+        source.stream(fpp::Media::Type::Video), sink, { 1, 2 }
+    };
+
+    /* open sink */
+    if (!sink.open()) {
+        return;
+    }
+
+    /* because of endless stream */
+    source.stream(fpp::Media::Type::Video)->setEndTimePoint(60 * 1000);
+
+    fpp::Packet packet;
+    const auto read_packet {
+        [&packet,&source]() {
+            packet = source.read();
+            return !packet.isEOF();
+        }
+    };
+
+    /* read and write keyframes */
+    while (read_packet()) {
+        if (!preview.write(packet)) {
+            break;
+        }
+    }
+
+    /* explicitly close contexts */
+    source.close();
+    sink.close();
+
+}
@@ -0,0 +1,108 @@
+#include "examples.hpp"
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/codec/DecoderContext.hpp>
+#include <fpp/codec/EncoderContext.hpp>
+#include <fpp/pipeline/Compositor.hpp>
+#include <fpp/core/time/Chronometer.hpp>
+#include <atomic>
+#include <thread>
+
+void mosaic() {
+
+    /* create sources */
+    const std::vector<std::string> cameras {
+          "rtsp://camera_0/live"
+        , "rtsp://camera_1/live"
+        , "rtsp://camera_2/live"
+        , "rtsp://camera_3/live"
+    };
+
+    /* 2x2 mosaic at 1280x720, 25 fps */
+    const auto out_params { fpp::VideoParameters::make_shared() };
+    out_params->setWidth(1280);
+    out_params->setHeight(720);
+    out_params->setFrameRate({ 25, 1 });
+    out_params->setTimeBase({ 1, 25 });
+    out_params->setPixelFormat(AV_PIX_FMT_YUV420P);
+    out_params->setEncoder(AV_CODEC_ID_H264);
+
+    /* create sink */
+    fpp::OutputFormatContext sink {
+        "mosaic.flv"
+    };
+    sink.createStream(out_params);
+
+    /* create encoder */
+    fpp::Options video_options {
+          { "preset",       "ultrafast"   }
+        , { "tune",         "zerolatency" }
+    };
+    fpp::EncoderContext video_encoder {
+        sink.stream(fpp::Media::Type::Video)->params, video_options
+    };
+
+    fpp::Compositor compositor {
+        sink.stream(fpp::Media::Type::Video)->params, 2, 2
+    };
+
+    /* every camera is decoded on its own thread
+     * and only pushes its latest picture */
+    std::atomic_bool stop { false };
+    std::vector<std::thread> feeds;
+    for (std::size_t i { 0 }; i < cameras.size(); ++i) {
+        feeds.emplace_back([&, i]() {
+            fpp::InputFormatContext source { cameras[i] };
+            if (!source.open()) {
+                return;
+            }
+            fpp::DecoderContext decoder {
+                source.stream(fpp::Media::Type::Video)->params
+            };
+            while (!stop) {
+                const auto packet { source.read() };
+                if (packet.isEOF()) {
+                    break;
+                }
+                if (!packet.isVideo()) {
+                    continue;
+                }
+                for (const auto& frame : decoder.decode(packet)) {
+                    compositor.push(i, frame);
+                }
+            }
+        });
+    }
+
+    /* open sink */
+    if (!sink.open()) {
+        stop = true;
+        for (auto& feed : feeds) {
+            feed.join();
+        }
+        return;
+    }
+
+    /* compose at the output frame rate for one minute */
+    constexpr auto frame_duration { std::chrono::milliseconds { 40 } };
+    constexpr auto nb_frames { 25 * 60 };
+    fpp::Chronometer chronometer;
+    for (auto frame_number { 0 }; frame_number < nb_frames; ++frame_number) {
+        std::this_thread::sleep_until(
+            std::chrono::steady_clock::now()
+                + (frame_duration * (frame_number + 1) - chronometer.elapsed_milliseconds())
+        );
+        for (auto& packet : video_encoder.encode(compositor.compose(frame_number))) {
+            sink.write(packet);
+        }
+    }
+
+    stop = true;
+    for (auto& feed : feeds) {
+        feed.join();
+    }
+
+    /* explicitly close context */
+    sink.close();
+
+}
@@ -0,0 +1,35 @@
+#include "examples.hpp"
+#include <fpp/pipeline/Remuxer.hpp>
+
+void remuxing() {
+
+    /* create source */
+    fpp::InputFormatContext source {
+        "big_buck_bunny.mp4"
+    };
+
+    /* open source */
+    if (!source.open()) {
+        return;
+    }
+
+    /* create sink, its streams are copied from the source
+     * and the h264 stream gets h264_mp4toannexb */
+    fpp::OutputFormatContext sink {
+        "remuxing.ts"
+    };
+
+    /* stream copy the first minute */
+    constexpr auto one_minute { 1 * 60 * 1000 };
+    for (const auto& input_stream : source.streams()) {
+        input_stream->setEndTimePoint(one_minute);
+    }
+
+    fpp::Remuxer remuxer { source, sink };
+    remuxer.remux();
+
+    /* explicitly close contexts */
+    source.close();
+    sink.close();
+
+}
@@ -45,17 +45,19 @@ void rtp_video_stream_transcoded() {
 
     /* create encoder's options */
     fpp::Options video_options {
-        { "threads",        "1"          }
-        , { "thread_type",  "slice"       }
-        , { "preset",       "ultrafast"   }
+          { "preset",       "ultrafast"   }
         , { "crf",          "15"          } // 0-51
         , { "profile",      "main"        }
         , { "tune",         "zerolatency" }
     };
 
+    /* slice threads on every core, no frame threading delay */
+    fpp::CodecThreading video_threading;
+    video_threading.low_latency = true;
+
     /* create encoder */
     fpp::EncoderContext video_encoder {
-        sink.stream(fpp::Media::Type::Video)->params, video_options
+        sink.stream(fpp::Media::Type::Video)->params, video_threading, video_options
     };
 
     /* create rescaler */
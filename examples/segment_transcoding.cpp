@@ -0,0 +1,27 @@
+#include "examples.hpp"
+#include <fpp/pipeline/SegmentTranscoder.hpp>
+
+void segment_transcoding() {
+
+    /* output params: h264 720p, the rest is taken from the source */
+    const auto video_params { fpp::VideoParameters::make_shared() };
+    video_params->setEncoder(AV_CODEC_ID_H264);
+    video_params->setWidth(1280);
+    video_params->setHeight(720);
+    video_params->setPixelFormat(AV_PIX_FMT_YUV420P);
+
+    /* one chunk per core, each encoder single threaded */
+    fpp::SegmentTranscoder::Settings settings;
+    settings.encoder_options = {
+          { "threads", "1"      }
+        , { "preset",  "medium" }
+        , { "crf",     "23"     }
+    };
+
+    fpp::SegmentTranscoder transcoder {
+        "movie.mkv", "movie_720p.mp4", video_params, settings
+    };
+
+    transcoder.transcode();
+
+}
@@ -0,0 +1,36 @@
+#include "examples.hpp"
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/pipeline/ThumbnailExtractor.hpp>
+
+void thumbnails() {
+
+    /* create source */
+    fpp::InputFormatContext source {
+        "big_buck_bunny.mp4"
+    };
+
+    /* open source */
+    if (!source.open()) {
+        return;
+    }
+
+    /* 320px wide jpeg thumbnails, workers by core count */
+    fpp::ThumbnailExtractor::Settings settings;
+    settings.width = 320;
+
+    fpp::ThumbnailExtractor extractor { source, settings };
+
+    /* thumbnail every 10 seconds */
+    for (const auto& thumbnail : extractor.extract(10 * 1000)) {
+        const auto file_name {
+            "thumb_" + std::to_string(thumbnail.timestamp) + ".jpg"
+        };
+        fpp::ThumbnailExtractor::save(thumbnail.image, file_name);
+    }
+
+    /* sprite sheet: 10 columns, thumbnail every 5 seconds */
+    fpp::ThumbnailExtractor::save(
+        extractor.spriteSheet(5 * 1000, 10), "sprite.jpg"
+    );
+
+}
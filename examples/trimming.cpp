@@ -0,0 +1,32 @@
+#include "examples.hpp"
+#include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/pipeline/Trimmer.hpp>
+
+void trimming() {
+
+    /* create sinks */
+    fpp::OutputFormatContext snapped_sink {
+        "clip_snapped.mkv"
+    };
+    fpp::OutputFormatContext exact_sink {
+        "clip_exact.mkv"
+    };
+
+    constexpr auto start { 60 * 1000 }; // 1 min
+    constexpr auto end   { 90 * 1000 }; // 1.5 min
+
+    /* stream copy of whole gops, starts at the keyframe before 1 min */
+    fpp::Trimmer snapped {
+        "recording.mkv", snapped_sink, start, end
+    };
+    snapped.trim();
+
+    /* frame exact: only the partial gops at the edges are re-encoded */
+    fpp::Trimmer exact {
+        "recording.mkv", exact_sink, start, end
+        , fpp::Trimmer::Mode::SmartCut
+        , {{ "preset", "veryfast" }, { "crf", "18" }}
+    };
+    exact.trim();
+
+}
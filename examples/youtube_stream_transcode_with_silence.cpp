@@ -80,10 +80,13 @@ void youtube_stream_transcode_with_silence() {
     fpp::DecoderContext audio_decoder {
         audio_source.stream(fpp::Media::Type::Audio)->params
     };
+    /* keep live audio in lip-sync with the video clock */
+    fpp::AudioSyncCorrection sync_correction;
+    sync_correction.enabled = true;
     fpp::ResampleContext resample {{
           audio_source.stream(fpp::Media::Type::Audio)->params
         , sink.stream(fpp::Media::Type::Audio)->params
-    }};
+    }, sync_correction };
     fpp::EncoderContext audio_encoder {
         sink.stream(fpp::Media::Type::Audio)->params
     };
@@ -1,6 +1,8 @@
 #include "CodecContext.hpp"
 #include <fpp/core/Utils.hpp>
 #include <fpp/core/FFmpegException.hpp>
+#include <algorithm>
+#include <thread>
 
 extern "C" {
     #include <libavformat/avformat.h>
@@ -8,6 +10,26 @@ extern "C" {
 
 namespace fpp {
 
+int CodecThreading::threadCount() const {
+    if (count > 0) {
+        return count;
+    }
+    const auto cores {
+        std::max(int(std::thread::hardware_concurrency()), 1)
+    };
+    return std::max(cores / int(std::max(channels, std::size_t { 1 })), 1);
+}
+
+int CodecThreading::threadType() const {
+    switch (mode) {
+        case Mode::Frame: return FF_THREAD_FRAME;
+        case Mode::Slice: return FF_THREAD_SLICE;
+        case Mode::Auto:  break;
+    }
+    /* frame threading delays output by a frame per thread */
+    return low_latency ? FF_THREAD_SLICE : (FF_THREAD_FRAME | FF_THREAD_SLICE);
+}
+
 CodecContext::CodecContext(const SpParameters params)
     : Media(params->type())
     , params { params } {
@@ -23,8 +45,15 @@ void CodecContext::init(Options options) {
     open(options);
 }
 
+void CodecContext::setThreading(const CodecThreading& threading) {
+    _threading = threading;
+}
+
 void CodecContext::open(Options options) {
     params->initCodecContext(raw());
+    if (_threading) {
+        applyThreading();
+    }
     Dictionary dictionary { options };
     if (const auto ret {
             ::avcodec_open2(raw(), codec(), dictionary.get())
@@ -39,6 +68,25 @@ void CodecContext::open(Options options) {
     params->parseCodecContext(raw());
 }
 
+void CodecContext::applyThreading() {
+    raw()->thread_count = _threading->threadCount();
+    raw()->thread_type  = _threading->threadType();
+    if (_threading->low_latency) {
+        raw()->flags |= AV_CODEC_FLAG_LOW_DELAY;
+        if (params->isEncoder()) {
+            raw()->max_b_frames = 0;
+        }
+    }
+}
+
+std::optional<CodecThreading> CodecContext::threading() const {
+    return _threading;
+}
+
+int CodecContext::threadCount() const {
+    return raw()->thread_count;
+}
+
 std::string CodecContext::toString() const {
     const auto separator { ", " };
     if (isVideo()) {
@@ -70,6 +118,26 @@ std::string CodecContext::toString() const {
     };
 }
 
+void CodecContext::storeTrace(std::int64_t pts, const Trace& trace) {
+    if (trace.empty() || (pts == NOPTS_VALUE)) {
+        return;
+    }
+    constexpr auto max_pending_traces { 64 };
+    if (_traces.size() >= max_pending_traces) {
+        _traces.erase(_traces.begin());
+    }
+    _traces[pts] = trace;
+}
+
+Trace CodecContext::takeTrace(std::int64_t pts) {
+    if (const auto it { _traces.find(pts) }; it != _traces.end()) {
+        const auto trace { it->second };
+        _traces.erase(it);
+        return trace;
+    }
+    return Trace {};
+}
+
 const AVCodec* CodecContext::codec() const {
     return params->codec();
 }
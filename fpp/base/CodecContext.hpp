@@ -2,11 +2,33 @@
 #include <fpp/core/wrap/SharedFFmpegObject.hpp>
 #include <fpp/base/Dictionary.hpp>
 #include <fpp/stream/Stream.hpp>
+#include <map>
+#include <optional>
 
 struct AVCodecContext;
 
 namespace fpp {
 
+/* Codec internal threading, applied before the codec is opened;
+ * "threads"/"thread_type" options still take precedence */
+struct CodecThreading {
+
+    enum class Mode : std::uint8_t {
+          Auto      ///< frame and slice, slice only in low latency mode
+        , Frame
+        , Slice
+    };
+
+    Mode                mode        { Mode::Auto };
+    int                 count       { 0 };      ///< 0 - cores divided by channels
+    std::size_t         channels    { 1 };      ///< codecs running concurrently on the host
+    bool                low_latency { false };  ///< no frame threading delay, no b-frames for encoders
+
+    int                 threadCount() const;
+    int                 threadType()  const;
+
+};
+
 class CodecContext : public SharedFFmpegObject<AVCodecContext>, public Media {
 
 public:
@@ -18,15 +40,30 @@ public:
     const AVCodec*      codec()  const;
     bool                opened();
 
+    std::optional<CodecThreading> threading() const;
+    int                 threadCount() const;
+
     const SpParameters  params;
 
 protected:
 
     void                init(Options options);
+    void                setThreading(const CodecThreading& threading);
+
+    /* codecs do not carry user data through,
+     * so traces are matched by timestamp */
+    void                storeTrace(std::int64_t pts, const Trace& trace);
+    Trace               takeTrace(std::int64_t pts);
 
 private:
 
     void                open(Options options);
+    void                applyThreading();
+
+private:
+
+    std::map<std::int64_t,Trace> _traces;
+    std::optional<CodecThreading> _threading;
 
 };
 
@@ -38,6 +38,14 @@ void FilterChain::write(const Frame& frame) {
     firstFilter().write(frame);
 }
 
+void FilterChain::write(Frame&& frame, bool push) {
+    firstFilter().write(std::move(frame), push);
+}
+
+void FilterChain::write(FrameVector&& frames, bool push) {
+    firstFilter().write(std::move(frames), push);
+}
+
 FilterContext& FilterChain::firstFilter() {
     return _chain.front();
 }
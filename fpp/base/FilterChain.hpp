@@ -16,6 +16,8 @@ public:
 
     FrameVector         read();
     void                write(const Frame& frame);
+    void                write(Frame&& frame, bool push = false);
+    void                write(FrameVector&& frames, bool push = false);
 
 private:
 
@@ -1,6 +1,7 @@
 #include "FilterContext.hpp"
 #include <fpp/core/FFmpegException.hpp>
 #include <fpp/core/Utils.hpp>
+#include <fpp/core/AllocationTracker.hpp>
 
 extern "C" {
 #include <libavfilter/buffersrc.h>
@@ -14,6 +15,14 @@ FilterContext::FilterContext(AVFilterGraph* graph
                            , const std::string_view unique_id
                            , const std::string_view args
                            , void* opaque)
+    : FilterContext(graph, getFilterByName(name), unique_id, args, opaque) {
+}
+
+FilterContext::FilterContext(AVFilterGraph* graph
+                           , const AVFilter* filter
+                           , const std::string_view unique_id
+                           , const std::string_view args
+                           , void* opaque)
     : _nb_input_pads  { 0 }
     , _nb_output_pads { 0 } {
     reset(
@@ -21,8 +30,8 @@ FilterContext::FilterContext(AVFilterGraph* graph
             AVFilterContext* flt_ctx { nullptr };
             ffmpeg_api_strict(avfilter_graph_create_filter
                 , &flt_ctx
-                , getFilterByName(name)
-                , (std::string { name } + '_' + unique_id.data()).c_str()
+                , filter
+                , (std::string { filter->name } + '_' + unique_id.data()).c_str()
                 , args.data()
                 , opaque
                 , graph
@@ -47,6 +56,7 @@ void FilterContext::setAudioBufferSinkFrameSize(unsigned frame_size) {
 }
 
 FrameVector FilterContext::read() {
+    FPP_ALLOCATION_STAGE(Filter);
     FrameVector filtered_frames;
     auto ret { 0 };
     while (ret == 0) {
@@ -58,16 +68,35 @@ FrameVector FilterContext::read() {
         if (ret < 0) {
             throw FFmpegException { "av_buffersink_get_frame failed" };
         }
+        if (auto trace { output_frame.trace() }; !trace.empty()) {
+            trace.mark(Trace::Hop::Filter);
+            output_frame.setTrace(trace);
+        }
         filtered_frames.push_back(output_frame);
     }
     return filtered_frames;
 }
 
 void FilterContext::write(const Frame& frame) {
+    FPP_ALLOCATION_SCOPE(Filter);
     ffmpeg_api_strict(av_buffersrc_write_frame, raw(), frame.ptr());
 }
 
-const AVFilter* FilterContext::getFilterByName(const std::string_view name) const {
+void FilterContext::write(Frame&& frame, bool push) {
+    FPP_ALLOCATION_SCOPE(Filter);
+    const auto flags { push ? AV_BUFFERSRC_FLAG_PUSH : 0 };
+    ffmpeg_api_strict(av_buffersrc_add_frame_flags, raw(), frame.ptr(), flags);
+}
+
+void FilterContext::write(FrameVector&& frames, bool push) {
+    for (std::size_t i { 0 }; i < frames.size(); ++i) {
+        const auto last { i + 1 == frames.size() };
+        write(std::move(frames[i]), push && last);
+    }
+    frames.clear();
+}
+
+const AVFilter* FilterContext::getFilterByName(const std::string_view name) {
     const auto filter {
         ::avfilter_get_by_name(name.data())
     };
@@ -17,16 +17,27 @@ public:
                 , const std::string_view unique_id
                 , const std::string_view args
                 , void* opaque);
+    FilterContext(AVFilterGraph* graph
+                , const AVFilter* filter
+                , const std::string_view unique_id
+                , const std::string_view args
+                , void* opaque);
 
     void                linkTo(FilterContext& other);
     void                setAudioBufferSinkFrameSize(unsigned frame_size);
 
     FrameVector         read();
     void                write(const Frame& frame);
+    /* hands the frame's buffers over to the buffer source without
+     * taking a new reference, the frame is left empty; push runs
+     * the graph right away instead of on the next read */
+    void                write(Frame&& frame, bool push = false);
+    /* only the last frame of the batch is pushed */
+    void                write(FrameVector&& frames, bool push = false);
 
 private:
 
-    const AVFilter*     getFilterByName(const std::string_view name) const;
+    static const AVFilter* getFilterByName(const std::string_view name);
 
 private:
 
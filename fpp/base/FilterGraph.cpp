@@ -2,6 +2,8 @@
 #include <fpp/stream/VideoParameters.hpp>
 #include <fpp/stream/AudioParameters.hpp>
 #include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/ThreadPool.hpp>
+#include <fpp/core/Utils.hpp>
 #include <cassert>
 
 extern "C" {
@@ -28,26 +30,88 @@ FilterGraph::FilterGraph(const Options& options)
     }
 }
 
+FilterGraph::FilterGraph(const FilterThreading& threading, const Options& options)
+    : FilterGraph(options) {
+    _threading = threading;
+    applyThreading();
+}
+
 void FilterGraph::init() {
     ffmpeg_api_strict(avfilter_graph_config, raw(), nullptr);
 }
 
+const FilterThreading& FilterGraph::threading() const {
+    return _threading;
+}
+
+bool FilterGraph::sendCommand(const std::string& target
+                            , const std::string& command
+                            , const std::string& arg
+                            , std::string* response) {
+    constexpr auto response_size { 256 };
+    char buffer[response_size] {};
+    constexpr auto flags { 0 };
+    if (const auto ret {
+            ::avfilter_graph_send_command(raw()
+                , target.c_str()
+                , command.c_str()
+                , arg.c_str()
+                , buffer
+                , response_size
+                , flags
+            )
+        }; ret < 0) {
+        log_warning() << "Command " << utils::quoted(command)
+                      << " to " << utils::quoted(target)
+                      << " failed: " << ret;
+        return false;
+    }
+    if (response) {
+        *response = buffer;
+    }
+    return true;
+}
+
+bool FilterGraph::queueCommand(const std::string& target
+                             , const std::string& command
+                             , const std::string& arg
+                             , double time) {
+    constexpr auto flags { 0 };
+    if (const auto ret {
+            ::avfilter_graph_queue_command(raw()
+                , target.c_str()
+                , command.c_str()
+                , arg.c_str()
+                , flags
+                , time
+            )
+        }; ret < 0) {
+        log_warning() << "Queue command " << utils::quoted(command)
+                      << " to " << utils::quoted(target)
+                      << " failed: " << ret;
+        return false;
+    }
+    return true;
+}
+
 std::string FilterGraph::genUniqueId() {
     return std::to_string(_filter_uid++);
 }
 
-FilterContext FilterGraph::createBufferSource(const SpParameters par) {
+std::shared_ptr<const FilterTemplate>
+FilterGraph::compile(const SpParameters par, const std::vector<std::string>& filters) const {
+    return FilterTemplateCache::instance().get(par, filters);
+}
+
+FilterContext FilterGraph::createBufferSource(const SpParameters par, const FilterTemplate& tmpl) {
     assert(par->isVideo() || par->isAudio());
     const auto filter_name {
         par->isVideo() ? "buffer" : "abuffer"
     };
-    const auto args {
-        par->isVideo() ? createVideoArgs(par) : createAudioArgs(par)
-    };
     constexpr void* opaque {
         nullptr
     };
-    return FilterContext { raw(), filter_name, genUniqueId(), args, opaque };
+    return FilterContext { raw(), filter_name, genUniqueId(), tmpl.source_args, opaque };
 }
 
 FilterContext FilterGraph::createBufferSink(const SpParameters par) {
@@ -78,61 +142,48 @@ FilterChain& FilterGraph::chain(std::size_t index) {
     return _filters[index];
 }
 
-std::pair<const std::string, const std::string>
-FilterGraph::extractNameArgs(const std::string_view filter_descr) const {
-    if (const auto eq_pos {
-        filter_descr.find('=')
-    }; eq_pos != std::string::npos) {
-        return {
-            std::string { filter_descr.substr(0, eq_pos) }
-            , std::string { filter_descr.substr(eq_pos + 1) }
-        };
-    }
-    return { std::string { filter_descr }, std::string {} };
-}
-
-std::vector<FilterContext> FilterGraph::createFilterContexts(const std::vector<std::string>& filters) {
+std::vector<FilterContext> FilterGraph::createFilterContexts(const FilterTemplate& tmpl) {
     std::vector<FilterContext> result;
-    for (const std::string& filter_descr : filters) {
-        const auto& [name, args] { extractNameArgs(filter_descr) };
-        const auto unique_id { genUniqueId() };
+    result.reserve(tmpl.filters.size());
+    for (const auto& flt : tmpl.filters) {
         constexpr void* opaque { nullptr };
-        result.emplace_back(raw(), name, unique_id, args, opaque);
+        result.emplace_back(raw(), flt.filter
+            , flt.instance.empty() ? genUniqueId() : flt.instance
+            , flt.args, opaque);
     }
     return result;
 }
 
-std::string FilterGraph::createVideoArgs(const SpParameters par) const {
-    const auto vpar {
-        std::static_pointer_cast<const VideoParameters>(par)
-    };
-    std::stringstream ss;
-    ss << "video_size=" << vpar->width()
-                        << 'x'
-                        << vpar->height();
-    ss << ":pix_fmt=" << vpar->pixelFormat();
-    ss << ":time_base=" << vpar->timeBase().num
-                        << '/'
-                        << vpar->timeBase().den;
-    ss << ":pixel_aspect=" << vpar->sampleAspectRatio().num
-                           << '/'
-                           << vpar->sampleAspectRatio().den;
-    return ss.str();
-}
-
-std::string FilterGraph::createAudioArgs(const SpParameters par) const {
-    const auto apar {
-        std::static_pointer_cast<const AudioParameters>(par)
-    };
-    std::stringstream ss;
-    ss << "time_base=" << apar->timeBase().num
-                       << '/'
-                       << apar->timeBase().den;
-    ss << ":sample_rate="    << apar->sampleRate();
-    ss << ":sample_fmt="     << apar->sampleFormat();
-    ss << ":channel_layout=" << apar->channelLayout();
-    ss << ":channels="       << apar->channels();
-    return ss.str();
+void FilterGraph::applyThreading() {
+    /* execute and thread settings are picked up by each filter
+     * when it is created, so they must be set before any filter */
+    switch (_threading.mode) {
+    case FilterThreading::Mode::None:
+        raw()->thread_type = 0;
+        raw()->nb_threads = 1;
+        break;
+    case FilterThreading::Mode::Slice:
+        raw()->thread_type = AVFILTER_THREAD_SLICE;
+        raw()->nb_threads = _threading.count;
+        break;
+    case FilterThreading::Mode::SharedPool:
+        raw()->thread_type = AVFILTER_THREAD_SLICE;
+        /* without libavfilter's pool nb_threads is not
+         * auto-detected, filters use it to split their work */
+        raw()->nb_threads = _threading.count > 0
+            ? _threading.count
+            : int(ThreadPool::shared().size());
+        raw()->execute = [](AVFilterContext* ctx, avfilter_action_func* func, void* arg, int* ret, int nb_jobs) {
+            ThreadPool::shared().parallelFor(nb_jobs, [&](int job) {
+                const auto job_ret { func(ctx, arg, job, nb_jobs) };
+                if (ret) {
+                    ret[job] = job_ret;
+                }
+            });
+            return 0;
+        };
+        break;
+    }
 }
 
 } // namespace fpp
@@ -2,38 +2,70 @@
 #include <fpp/base/FilterChain.hpp>
 #include <fpp/base/Parameters.hpp>
 #include <fpp/base/Dictionary.hpp>
+#include <fpp/base/FilterTemplateCache.hpp>
 
 struct AVFilterGraph;
+struct AVFilterContext;
 
 namespace fpp {
 
+struct FilterThreading {
+
+    enum class Mode : std::uint8_t {
+          None          ///< every filter runs on the calling thread
+        , Slice         ///< slice threads from the graph's own thread pool
+        , SharedPool    ///< slice jobs run on ThreadPool::shared()
+    };
+
+    Mode                mode        { Mode::Slice };
+    int                 count       { 0 };  ///< 0 - cores (Slice) or pool size (SharedPool)
+
+};
+
 class FilterGraph : public SharedFFmpegObject<AVFilterGraph> {
 
 public:
 
     explicit FilterGraph(const Options& options);
+    FilterGraph(const FilterThreading& threading, const Options& options);
 
     void                init();
 
+    const FilterThreading& threading() const;
+
+    /* reconfigures running filters in place, target is an instance
+     * name given as "type@instance" in the filter description, a type
+     * name (every filter of the type) or "all"; false if no filter
+     * accepted it */
+    bool                sendCommand(const std::string& target
+                                  , const std::string& command
+                                  , const std::string& arg
+                                  , std::string* response = nullptr);
+    /* same as sendCommand, applied when the filter reaches
+     * a frame with time (in seconds) not less than time */
+    bool                queueCommand(const std::string& target
+                                   , const std::string& command
+                                   , const std::string& arg
+                                   , double time);
+
 protected:
 
     std::string         genUniqueId();
 
-    FilterContext       createBufferSource(const SpParameters par);
+    std::shared_ptr<const FilterTemplate>
+    compile(const SpParameters par, const std::vector<std::string>& filters) const;
+
+    FilterContext       createBufferSource(const SpParameters par, const FilterTemplate& tmpl);
     FilterContext       createBufferSink(const SpParameters par);
 
     std::size_t         emplaceFilterChainBack(FilterChain chain);
     FilterChain&        chain(std::size_t index);
 
-    std::pair<const std::string, const std::string>
-    extractNameArgs(const std::string_view filter_descr) const;
-
-    std::vector<FilterContext> createFilterContexts(const std::vector<std::string>& filters);
+    std::vector<FilterContext> createFilterContexts(const FilterTemplate& tmpl);
 
 private:
 
-    std::string         createVideoArgs(const SpParameters par) const;
-    std::string         createAudioArgs(const SpParameters par) const;
+    void                applyThreading();
 
 private:
 
@@ -41,6 +73,7 @@ private:
 
     FilterChainVector   _filters;
     std::size_t         _filter_uid;
+    FilterThreading     _threading;
 
 };
 
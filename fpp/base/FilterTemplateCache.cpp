@@ -0,0 +1,130 @@
+#include "FilterTemplateCache.hpp"
+#include <fpp/stream/VideoParameters.hpp>
+#include <fpp/stream/AudioParameters.hpp>
+#include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/Utils.hpp>
+
+extern "C" {
+    #include <libavfilter/avfilter.h>
+}
+
+namespace fpp {
+
+FilterTemplateCache::FilterTemplateCache()
+    : _hits { 0 }
+    , _misses { 0 } {
+}
+
+FilterTemplateCache& FilterTemplateCache::instance() {
+    static FilterTemplateCache cache;
+    return cache;
+}
+
+std::shared_ptr<const FilterTemplate>
+FilterTemplateCache::get(const SpParameters par, const std::vector<std::string>& filters) {
+    /* source args describe everything the buffer source
+     * depends on, so together with the filters they are the key */
+    auto key { sourceArgs(par) };
+    for (const auto& filter_descr : filters) {
+        key += '\n';
+        key += filter_descr;
+    }
+
+    std::lock_guard lock { _mutex };
+    if (const auto it { _templates.find(key) }; it != _templates.end()) {
+        _hits++;
+        return it->second;
+    }
+    _misses++;
+    const auto compiled {
+        std::make_shared<const FilterTemplate>(compile(par, filters))
+    };
+    _templates.emplace(std::move(key), compiled);
+    return compiled;
+}
+
+std::size_t FilterTemplateCache::size() const {
+    std::lock_guard lock { _mutex };
+    return _templates.size();
+}
+
+std::int64_t FilterTemplateCache::hits() const {
+    std::lock_guard lock { _mutex };
+    return _hits;
+}
+
+std::int64_t FilterTemplateCache::misses() const {
+    std::lock_guard lock { _mutex };
+    return _misses;
+}
+
+void FilterTemplateCache::clear() {
+    std::lock_guard lock { _mutex };
+    _templates.clear();
+}
+
+std::string FilterTemplateCache::sourceArgs(const SpParameters par) {
+    if (par->isVideo()) {
+        const auto vpar {
+            std::static_pointer_cast<const VideoParameters>(par)
+        };
+        return "video_size="    + std::to_string(vpar->width())
+                + 'x'           + std::to_string(vpar->height())
+            + ":pix_fmt="       + utils::to_string(vpar->pixelFormat())
+            + ":time_base="     + std::to_string(vpar->timeBase().num)
+                + '/'           + std::to_string(vpar->timeBase().den)
+            + ":pixel_aspect="  + std::to_string(vpar->sampleAspectRatio().num)
+                + '/'           + std::to_string(vpar->sampleAspectRatio().den);
+    }
+    if (par->isAudio()) {
+        const auto apar {
+            std::static_pointer_cast<const AudioParameters>(par)
+        };
+        return "time_base="     + std::to_string(apar->timeBase().num)
+                + '/'           + std::to_string(apar->timeBase().den)
+            + ":sample_rate="   + std::to_string(apar->sampleRate())
+            + ":sample_fmt="    + utils::to_string(apar->sampleFormat())
+            + ":channel_layout="+ std::to_string(apar->channelLayout())
+            + ":channels="      + std::to_string(apar->channels());
+    }
+    return {};
+}
+
+FilterTemplate FilterTemplateCache::compile(const SpParameters par, const std::vector<std::string>& filters) const {
+    FilterTemplate result;
+    result.source_args = sourceArgs(par);
+    result.filters.reserve(filters.size());
+    for (const auto& filter_descr : filters) {
+        auto [name, args] { extractNameArgs(filter_descr) };
+        /* "name@instance" names the filter for commands, as in ffmpeg */
+        std::string instance;
+        if (const auto at_pos { name.find('@') }; at_pos != std::string::npos) {
+            instance = name.substr(at_pos + 1);
+            name.erase(at_pos);
+        }
+        const auto filter { ::avfilter_get_by_name(name.c_str()) };
+        if (!filter) {
+            throw FFmpegException {
+                "Failed to found " + name + " filter!"
+            };
+        }
+        result.filters.push_back({ filter, std::move(name), std::move(instance), std::move(args) });
+    }
+    log_info() << "Compiled filter template: " << filters.size() << " filters";
+    return result;
+}
+
+std::pair<std::string, std::string>
+FilterTemplateCache::extractNameArgs(const std::string_view filter_descr) {
+    if (const auto eq_pos {
+        filter_descr.find('=')
+    }; eq_pos != std::string::npos) {
+        return {
+            std::string { filter_descr.substr(0, eq_pos) }
+            , std::string { filter_descr.substr(eq_pos + 1) }
+        };
+    }
+    return { std::string { filter_descr }, std::string {} };
+}
+
+} // namespace fpp
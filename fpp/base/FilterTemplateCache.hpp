@@ -0,0 +1,66 @@
+#pragma once
+#include <fpp/base/Parameters.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct AVFilter;
+
+namespace fpp {
+
+/* Parsed form of a filter chain: buffer source arguments
+ * and resolved filters, ready to be instantiated in a graph */
+struct FilterTemplate {
+
+    struct Filter {
+        const AVFilter* filter;
+        std::string     name;
+        std::string     instance;   ///< from "name@instance", empty if not given
+        std::string     args;
+    };
+
+    std::string         source_args;
+    std::vector<Filter> filters;
+
+};
+
+/* Compiles each (filter list, input parameters) pair once per process,
+ * new channels with the same topology reuse the compiled template */
+class FilterTemplateCache : public Object {
+
+public:
+
+    static FilterTemplateCache& instance();
+
+    std::shared_ptr<const FilterTemplate> get(const SpParameters par, const std::vector<std::string>& filters);
+
+    std::size_t         size()   const;
+    std::int64_t        hits()   const;
+    std::int64_t        misses() const;
+    void                clear();
+
+    static std::string  sourceArgs(const SpParameters par);
+
+private:
+
+    FilterTemplateCache();
+
+    FilterTemplate      compile(const SpParameters par, const std::vector<std::string>& filters) const;
+
+    static std::pair<std::string, std::string>
+    extractNameArgs(const std::string_view filter_descr);
+
+private:
+
+    using TemplateMap = std::unordered_map<std::string, std::shared_ptr<const FilterTemplate>>;
+
+    mutable std::mutex  _mutex;
+    TemplateMap         _templates;
+    std::int64_t        _hits;
+    std::int64_t        _misses;
+
+};
+
+} // namespace fpp
@@ -13,6 +13,8 @@ struct AVStream;
 
 namespace fpp {
 
+class Remuxer;
+
 class FormatContext : public SharedFFmpegObject<AVFormatContext> {
 
 public:
@@ -94,6 +96,9 @@ protected:
 
 private:
 
+    /* arms the interrupt timeouts from its own read/write loop */
+    friend class Remuxer;
+
     void                setOpened(bool opened);
     static int          interrupt_callback(void* opaque);
 
@@ -1,9 +1,11 @@
 #include "Frame.hpp"
 #include <fpp/core/Utils.hpp>
 #include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/AllocationTracker.hpp>
 
 extern "C" {
     #include <libavutil/imgutils.h>
+    #include <libavutil/buffer.h>
 }
 
 namespace fpp {
@@ -19,6 +21,13 @@ Frame::Frame(const Frame& other)
     ref(other);
 }
 
+Frame::Frame(Frame&& other) noexcept
+    : Frame(other.type()) {
+    ::av_frame_move_ref(ptr(), other.ptr());
+    setTimeBase(other.timeBase());
+    setStreamIndex(other.streamIndex());
+}
+
 Frame::Frame(const AVFrame& frame, Media::Type type, AVRational time_base, int stream_index)
     : Frame(type) {
     ref(frame, time_base, stream_index);
@@ -35,6 +44,17 @@ Frame& Frame::operator=(const Frame& other) {
     return *this;
 }
 
+Frame& Frame::operator=(Frame&& other) noexcept {
+    if (this != &other) {
+        unref();
+        ::av_frame_move_ref(ptr(), other.ptr());
+        setTimeBase(other.timeBase());
+        setStreamIndex(other.streamIndex());
+        setType(other.type());
+    }
+    return *this;
+}
+
 std::int64_t Frame::pts() const {
     return raw().pts;
 }
@@ -51,6 +71,18 @@ void Frame::setStreamIndex(int stream_index) {
     _stream_index = stream_index;
 }
 
+void Frame::setTrace(const Trace& trace) {
+    /* opaque_ref survives av_frame_ref/av_frame_copy_props,
+     * so the trace passes through filters and rescaler */
+    ::av_buffer_unref(&raw().opaque_ref);
+    raw().opaque_ref = ::av_buffer_alloc(int(sizeof(Trace)));
+    if (!raw().opaque_ref) {
+        throw std::bad_alloc {};
+    }
+    FPP_COUNT_BUFFER_ALLOCATION();
+    ::memcpy(raw().opaque_ref->data, &trace, sizeof(Trace));
+}
+
 AVRational Frame::timeBase() const {
     return _time_base;
 }
@@ -67,6 +99,15 @@ int Frame::nbSamples() const {
     return raw().nb_samples;
 }
 
+Trace Frame::trace() const {
+    Trace trace;
+    if (const auto buf { raw().opaque_ref };
+            buf && (std::size_t(buf->size) == sizeof(Trace))) {
+        ::memcpy(&trace, buf->data, sizeof(Trace));
+    }
+    return trace;
+}
+
 int Frame::size() const {
     if (isVideo()) {
         return ::av_image_get_buffer_size(
@@ -132,6 +173,9 @@ void Frame::ref(const Frame& other) {
 }
 
 void Frame::ref(const AVFrame& other, AVRational time_base, int stream_index) {
+    if (!other.buf[0]) { /* av_frame_ref copies non refcounted data */
+        FPP_COUNT_BUFFER_ALLOCATION();
+    }
     ffmpeg_api_strict(av_frame_ref, ptr(), &other);
     setTimeBase(time_base);
     setStreamIndex(stream_index);
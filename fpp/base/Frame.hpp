@@ -1,6 +1,7 @@
 #pragma once
 #include <fpp/core/wrap/FFmpegObject.hpp>
 #include <fpp/base/MediaData.hpp>
+#include <fpp/core/time/Trace.hpp>
 #include <vector>
 
 extern "C" {
@@ -15,20 +16,24 @@ public:
 
     explicit Frame(Media::Type type = Media::Type::Unknown);
     Frame(const Frame& other);
+    Frame(Frame&& other) noexcept;
     Frame(const AVFrame& frame, Media::Type type, AVRational time_base, int stream_index);
     ~Frame() override;
 
     Frame& operator=(const Frame& other);
+    Frame& operator=(Frame&& other) noexcept;
 
     std::int64_t        pts() const;
     void                setPts(std::int64_t pts);
     void                setTimeBase(AVRational time_base);
     void                setStreamIndex(int stream_index);
+    void                setTrace(const Trace& trace);
 
     AVRational          timeBase()  const;
     int                 streamIndex()  const;
     bool                keyFrame()  const;
     int                 nbSamples() const;
+    Trace               trace()     const;
 
     int                 size()      const;
     std::string         toString()  const override;
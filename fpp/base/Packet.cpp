@@ -1,6 +1,7 @@
 #include "Packet.hpp"
 #include <fpp/core/Utils.hpp>
 #include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/AllocationTracker.hpp>
 
 namespace fpp {
 
@@ -14,6 +15,13 @@ Packet::Packet(const Packet& other)
     ref(other);
 }
 
+Packet::Packet(Packet&& other) noexcept
+    : Packet(other.type()) {
+    ::av_packet_move_ref(ptr(), other.ptr());
+    setTimeBase(other.timeBase());
+    setTrace(other.trace());
+}
+
 Packet::Packet(const AVPacket& avpacket, AVRational time_base, Media::Type type)
     : Packet(type) {
     ref(avpacket, time_base);
@@ -30,6 +38,17 @@ Packet& Packet::operator=(const Packet& other) {
     return *this;
 }
 
+Packet& Packet::operator=(Packet&& other) noexcept {
+    if (this != &other) {
+        unref();
+        ::av_packet_move_ref(ptr(), other.ptr());
+        setTimeBase(other.timeBase());
+        setTrace(other.trace());
+        setType(other.type());
+    }
+    return *this;
+}
+
 void Packet::setPts(std::int64_t pts) {
     raw().pts = pts;
 }
@@ -54,6 +73,10 @@ void Packet::setStreamIndex(int stream_index) {
     raw().stream_index = stream_index;
 }
 
+void Packet::setTrace(const Trace& trace) {
+    _trace = trace;
+}
+
 int64_t Packet::pts() const {
     return raw().pts;
 }
@@ -82,6 +105,10 @@ bool Packet::keyFrame() const {
     return raw().flags & AV_PKT_FLAG_KEY;
 }
 
+const Trace& Packet::trace() const {
+    return _trace;
+}
+
 int Packet::size() const {
     return raw().size;
 }
@@ -103,9 +130,13 @@ std::string Packet::toString() const {
 
 void Packet::ref(const Packet& other) {
     ref(other.raw(), other.timeBase());
+    setTrace(other.trace());
 }
 
 void Packet::ref(const AVPacket& other, AVRational time_base) {
+    if (!other.buf) { /* av_packet_ref copies non refcounted data */
+        FPP_COUNT_BUFFER_ALLOCATION();
+    }
     ffmpeg_api_strict(av_packet_ref, ptr(), &other);
     setTimeBase(time_base);
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <fpp/core/wrap/FFmpegObject.hpp>
 #include <fpp/base/MediaData.hpp>
+#include <fpp/core/time/Trace.hpp>
 #include <vector>
 
 extern "C" {
@@ -15,10 +16,12 @@ public:
 
     explicit Packet(Media::Type type = Media::Type::Unknown);
     Packet(const Packet& other);
+    Packet(Packet&& other) noexcept;
     Packet(const AVPacket& avpacket, AVRational time_base, Type type);
     ~Packet() override;
 
     Packet& operator=(const Packet& other);
+    Packet& operator=(Packet&& other) noexcept;
 
     void                setPts(std::int64_t pts);
     void                setDts(std::int64_t dts);
@@ -26,6 +29,7 @@ public:
     void                setDuration(std::int64_t duration);
     void                setTimeBase(AVRational time_base);
     void                setStreamIndex(int stream_index);
+    void                setTrace(const Trace& trace);
 
     std::int64_t        pts()           const;
     std::int64_t        dts()           const;
@@ -34,6 +38,7 @@ public:
     std::int64_t        pos()           const;
     int                 streamIndex()   const;
     bool                keyFrame()      const;
+    const Trace&        trace()         const;
 
     int                 size()          const;
     std::string         toString()      const override;
@@ -47,6 +52,7 @@ private:
 private:
 
     AVRational          _time_base;
+    Trace               _trace;
 
 };
 
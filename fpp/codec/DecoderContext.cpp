@@ -1,17 +1,34 @@
 #include "DecoderContext.hpp"
 #include <fpp/core/Utils.hpp>
 #include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/AllocationTracker.hpp>
+#include <algorithm>
 #include <cassert>
 
 namespace fpp {
 
 DecoderContext::DecoderContext(const SpParameters params, Options options)
-    : CodecContext(params) {
+    : CodecContext(params)
+    , _decode_mode { DecodeMode::All }
+    , _nth { 1 }
+    , _decoded_frames { 0 } {
     assert(params->isDecoder());
     init(options);
 }
 
+DecoderContext::DecoderContext(const SpParameters params, const CodecThreading& threading, Options options)
+    : CodecContext(params)
+    , _decode_mode { DecodeMode::All }
+    , _nth { 1 }
+    , _decoded_frames { 0 } {
+    assert(params->isDecoder());
+    setThreading(threading);
+    init(options);
+}
+
 FrameVector DecoderContext::decode(const Packet& packet) {
+    FPP_ALLOCATION_SCOPE(Decode);
+    storeTrace(packet.pts(), packet.trace());
     sendPacket(packet);
     return receiveFrames(packet.timeBase(), packet.streamIndex());
 }
@@ -21,6 +38,35 @@ FrameVector DecoderContext::flush(AVRational time_base, int stream_index) {
     return receiveFrames(time_base, stream_index);
 }
 
+void DecoderContext::flushBuffers() {
+    ::avcodec_flush_buffers(raw());
+}
+
+void DecoderContext::setDecodeMode(DecodeMode mode, std::size_t nth) {
+    const auto [skip_frame, skip_loop_filter] {
+        [mode]() -> std::pair<AVDiscard,AVDiscard> {
+            switch (mode) {
+                case DecodeMode::All:               return { AVDISCARD_DEFAULT, AVDISCARD_DEFAULT };
+                case DecodeMode::SkipNonRef:        return { AVDISCARD_NONREF,  AVDISCARD_DEFAULT };
+                case DecodeMode::KeyframesOnly:     return { AVDISCARD_NONKEY,  AVDISCARD_DEFAULT };
+                case DecodeMode::EveryNth:          return { AVDISCARD_NONREF,  AVDISCARD_DEFAULT };
+                case DecodeMode::ReducedLoopFilter: return { AVDISCARD_DEFAULT, AVDISCARD_ALL     };
+            }
+            return { AVDISCARD_DEFAULT, AVDISCARD_DEFAULT };
+        }()
+    };
+    raw()->skip_frame       = skip_frame;
+    raw()->skip_loop_filter = skip_loop_filter;
+    _decode_mode    = mode;
+    _nth            = std::max(nth, std::size_t { 1 });
+    _decoded_frames = 0;
+    log_info() << "Decode mode " << utils::to_string(mode) << (mode == DecodeMode::EveryNth ? ", nth " + std::to_string(_nth) : "");
+}
+
+DecoderContext::DecodeMode DecoderContext::decodeMode() const {
+    return _decode_mode;
+}
+
 void DecoderContext::sendPacket(const Packet& packet) {
     if (const auto ret {
             ::avcodec_send_packet(raw(), &packet.raw())
@@ -53,12 +99,26 @@ FrameVector DecoderContext::receiveFrames(AVRational time_base, int stream_index
                 utils::receive_frame_error_to_string(ret)
             };
         }
+        if (skipDecodedFrame()) {
+            continue;
+        }
         output_frame.setTimeBase(time_base);
         output_frame.setStreamIndex(stream_index);
         output_frame.raw().pict_type = AV_PICTURE_TYPE_NONE; // TODO check it 0904
+        if (auto trace { takeTrace(output_frame.raw().best_effort_timestamp) }; !trace.empty()) {
+            trace.mark(Trace::Hop::Decode);
+            output_frame.setTrace(trace);
+        }
         decoded_frames.push_back(output_frame);
     }
     return decoded_frames;
 }
 
+bool DecoderContext::skipDecodedFrame() {
+    if (_decode_mode != DecodeMode::EveryNth) {
+        return false;
+    }
+    return (_decoded_frames++ % _nth) != 0;
+}
+
 } // namespace fpp
@@ -9,16 +9,38 @@ class DecoderContext : public CodecContext {
 
 public:
 
+    /* can be switched at runtime, the decoder
+     * settles on the next keyframe */
+    enum class DecodeMode : std::uint8_t {
+          All
+        , SkipNonRef        ///< non-reference frames are not decoded
+        , KeyframesOnly
+        , EveryNth          ///< non-reference frames skipped, every Nth decoded frame returned
+        , ReducedLoopFilter ///< deblocking skipped, lower quality
+    };
+
     explicit DecoderContext(const SpParameters params, Options options = {});
+    DecoderContext(const SpParameters params, const CodecThreading& threading, Options options = {});
 
     FrameVector         decode(const Packet& packet);
     FrameVector         flush(AVRational time_base, int stream_index);
+    void                flushBuffers();
+
+    void                setDecodeMode(DecodeMode mode, std::size_t nth = 2);
+    DecodeMode          decodeMode() const;
 
 private:
 
     void                sendPacket(const Packet& packet);
     void                sendFlushPacket();
     FrameVector         receiveFrames(AVRational time_base, int stream_index);
+    bool                skipDecodedFrame();
+
+private:
+
+    DecodeMode          _decode_mode;
+    std::size_t         _nth;
+    std::size_t         _decoded_frames;
 
 };
 
@@ -1,6 +1,7 @@
 #include "EncoderContext.hpp"
 #include <fpp/core/Utils.hpp>
 #include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/AllocationTracker.hpp>
 #include <cassert>
 
 namespace fpp {
@@ -11,7 +12,16 @@ EncoderContext::EncoderContext(const SpParameters params, Options options)
     init(options);
 }
 
+EncoderContext::EncoderContext(const SpParameters params, const CodecThreading& threading, Options options)
+    : CodecContext(params) {
+    assert(params->isEncoder());
+    setThreading(threading);
+    init(options);
+}
+
 PacketVector EncoderContext::encode(const Frame& frame) {
+    FPP_ALLOCATION_SCOPE(Encode);
+    storeTrace(frame.pts(), frame.trace());
     sendFrame(frame);
     return receivePackets(frame.timeBase(), frame.streamIndex());
 }
@@ -57,6 +67,10 @@ PacketVector EncoderContext::receivePackets(AVRational time_base, int stream_ind
         }
         packet.setStreamIndex(stream_index);
         packet.setTimeBase(time_base);
+        if (auto trace { takeTrace(packet.pts()) }; !trace.empty()) {
+            trace.mark(Trace::Hop::Encode);
+            packet.setTrace(trace);
+        }
         encoded_packets.push_back(packet);
     }
     return encoded_packets;
@@ -10,6 +10,7 @@ class EncoderContext : public CodecContext {
 public:
 
     explicit EncoderContext(const SpParameters params, Options options = {});
+    EncoderContext(const SpParameters params, const CodecThreading& threading, Options options = {});
 
     PacketVector        encode(const Frame& frame);
     PacketVector        flush(AVRational time_base, int stream_index);
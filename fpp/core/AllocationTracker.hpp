@@ -0,0 +1,112 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace fpp {
+
+/* Counts heap allocations and FFmpeg buffer creations per pipeline stage.
+ * Stage hooks are compiled in only with FPP_TRACK_ALLOCATIONS
+ * (qmake: CONFIG += fpp_alloc_tracking). Heap allocations are reported
+ * by the application's operator new via countHeapAllocation() */
+class AllocationTracker {
+
+public:
+
+    enum class Stage : std::uint8_t {
+          Other
+        , Read
+        , Decode
+        , Filter
+        , Rescale
+        , Resample
+        , Encode
+        , Write
+        , EnumSize
+    };
+
+    struct Counters {
+        std::int64_t    processed;
+        std::int64_t    heap_allocations;
+        std::int64_t    buffer_allocations;
+    };
+
+    static AllocationTracker& instance();
+
+    void                countHeapAllocation();
+    void                countBufferAllocation();
+    void                countProcessed(Stage stage);
+
+    Counters            counters(Stage stage) const;
+    void                reset();
+
+    std::string         report() const;
+
+    static Stage        currentStage();
+    static void         setCurrentStage(Stage stage);
+
+private:
+
+    AllocationTracker() = default;
+
+    AllocationTracker(const AllocationTracker&)            = delete;
+    AllocationTracker(AllocationTracker&&)                 = delete;
+    AllocationTracker& operator=(const AllocationTracker&) = delete;
+    AllocationTracker& operator=(AllocationTracker&&)      = delete;
+
+private:
+
+    using CounterArray = std::array<std::atomic<std::int64_t>,std::size_t(Stage::EnumSize)>;
+
+    CounterArray        _processed          {};
+    CounterArray        _heap_allocations   {};
+    CounterArray        _buffer_allocations {};
+
+};
+
+/* Attributes allocations made during its lifetime to the stage
+ * and optionally counts one processed packet/frame */
+class AllocationScope {
+
+public:
+
+    explicit AllocationScope(AllocationTracker::Stage stage, bool count_processed = true)
+        : _prev_stage { AllocationTracker::currentStage() } {
+        AllocationTracker::setCurrentStage(stage);
+        if (count_processed) {
+            AllocationTracker::instance().countProcessed(stage);
+        }
+    }
+
+    ~AllocationScope() {
+        AllocationTracker::setCurrentStage(_prev_stage);
+    }
+
+    AllocationScope(const AllocationScope&)            = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+
+    const AllocationTracker::Stage _prev_stage;
+
+};
+
+} // namespace fpp
+
+#ifdef FPP_TRACK_ALLOCATIONS
+    #define FPP_ALLOCATION_SCOPE(stage)                     \
+        const fpp::AllocationScope _allocation_scope {      \
+            fpp::AllocationTracker::Stage::stage            \
+        }
+    #define FPP_ALLOCATION_STAGE(stage)                     \
+        const fpp::AllocationScope _allocation_scope {      \
+            fpp::AllocationTracker::Stage::stage, false     \
+        }
+    #define FPP_COUNT_BUFFER_ALLOCATION()                   \
+        fpp::AllocationTracker::instance().countBufferAllocation()
+#else
+    #define FPP_ALLOCATION_SCOPE(stage)     do {} while (false)
+    #define FPP_ALLOCATION_STAGE(stage)     do {} while (false)
+    #define FPP_COUNT_BUFFER_ALLOCATION()   do {} while (false)
+#endif
@@ -0,0 +1,104 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace fpp {
+
+ThreadPool::ThreadPool(std::size_t size)
+    : _stopped { false } {
+    const auto nb_workers { std::max(size, std::size_t { 1 }) };
+    _workers.reserve(nb_workers);
+    for (std::size_t i { 0 }; i < nb_workers; ++i) {
+        _workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock { _mutex };
+        _stopped = true;
+    }
+    _condition.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+std::size_t ThreadPool::size() const {
+    return _workers.size();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard lock { _mutex };
+        _tasks.push(std::move(task));
+    }
+    _condition.notify_one();
+}
+
+void ThreadPool::parallelFor(int nb_jobs, const std::function<void(int)>& job) {
+    if (nb_jobs <= 0) {
+        return;
+    }
+    if (nb_jobs == 1) {
+        job(0);
+        return;
+    }
+
+    /* shared with the helpers, which may start after the caller
+     * has already finished every job and returned */
+    struct Batch {
+        std::function<void(int)> job;
+        int                 nb_jobs;
+        std::atomic_int     next { 0 };
+        std::atomic_int     done { 0 };
+        std::mutex          mutex;
+        std::condition_variable finished;
+
+        void run() {
+            for (auto i { next++ }; i < nb_jobs; i = next++) {
+                job(i);
+                if (++done == nb_jobs) {
+                    std::lock_guard lock { mutex };
+                    finished.notify_all();
+                }
+            }
+        }
+    };
+    const auto batch { std::make_shared<Batch>() };
+    batch->job = job;
+    batch->nb_jobs = nb_jobs;
+
+    const auto nb_helpers { std::min(std::size_t(nb_jobs - 1), size()) };
+    for (std::size_t i { 0 }; i < nb_helpers; ++i) {
+        submit([batch]() { batch->run(); });
+    }
+    batch->run();
+
+    std::unique_lock lock { batch->mutex };
+    batch->finished.wait(lock, [&batch]() { return batch->done == batch->nb_jobs; });
+}
+
+void ThreadPool::work() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock { _mutex };
+            _condition.wait(lock, [this]() { return _stopped || !_tasks.empty(); });
+            if (_stopped && _tasks.empty()) {
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+        task();
+    }
+}
+
+} // namespace fpp
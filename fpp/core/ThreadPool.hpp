@@ -0,0 +1,49 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace fpp {
+
+/* Fixed set of worker threads shared by every component that needs
+ * short parallel jobs (filter slices, tile scaling). The calling thread
+ * takes part in parallelFor, so nested or concurrent batches always
+ * make progress even when every worker is busy */
+class ThreadPool {
+
+public:
+
+    explicit ThreadPool(std::size_t size = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    static ThreadPool&  shared();
+
+    std::size_t         size() const;
+
+    void                submit(std::function<void()> task);
+    /* runs job(0) ... job(nb_jobs - 1), returns when all are done */
+    void                parallelFor(int nb_jobs, const std::function<void(int)>& job);
+
+private:
+
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool(ThreadPool&&)                 = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&)      = delete;
+
+    void                work();
+
+private:
+
+    std::vector<std::thread> _workers;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex          _mutex;
+    std::condition_variable _condition;
+    bool                _stopped;
+
+};
+
+} // namespace fpp
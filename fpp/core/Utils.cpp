@@ -36,6 +36,22 @@ namespace fpp {
         return "Invalid";
     }
 
+    std::string utils::to_string(DecoderContext::DecodeMode mode) {
+        switch (mode) {
+        case DecoderContext::DecodeMode::All:
+            return "All";
+        case DecoderContext::DecodeMode::SkipNonRef:
+            return "SkipNonRef";
+        case DecoderContext::DecodeMode::KeyframesOnly:
+            return "KeyframesOnly";
+        case DecoderContext::DecodeMode::EveryNth:
+            return "EveryNth";
+        case DecoderContext::DecodeMode::ReducedLoopFilter:
+            return "ReducedLoopFilter";
+        }
+        return "Invalid";
+    }
+
     std::string utils::to_string(AVMediaType type) {
         switch (type) {
         case AVMediaType::AVMEDIA_TYPE_UNKNOWN:
@@ -201,6 +217,12 @@ namespace fpp {
         if (media_resurs_locator.find("sine=") != std::string_view::npos) {
             return "lavfi";
         }
+        if (media_resurs_locator.find("testsrc=") != std::string_view::npos) {
+            return "lavfi";
+        }
+        if (media_resurs_locator.find("testsrc2=") != std::string_view::npos) {
+            return "lavfi";
+        }
         if (media_resurs_locator.find("video=") != std::string_view::npos) {
             return "dshow";
         }
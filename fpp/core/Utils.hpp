@@ -1,6 +1,7 @@
 #pragma once
 #include <fpp/stream/Stream.hpp>
 #include <fpp/base/Parameters.hpp>
+#include <fpp/codec/DecoderContext.hpp>
 #include <sstream>
 
 constexpr auto ffmpeg_4_0 { AV_VERSION_INT(56,14,100) };
@@ -33,6 +34,7 @@ namespace fpp {
         static std::string  to_string(AVPixelFormat pxl_fmt);
         static std::string  to_string(bool value);
         static std::string  to_string(Media::Type type);
+        static std::string  to_string(DecoderContext::DecodeMode mode);
         static std::string  pts_to_string(std::int64_t pts);
         static std::string  time_to_string(std::int64_t time_stamp, AVRational time_base);
         static std::string  channel_layout_to_string(int nb_channels, std::uint64_t channel_layout);
@@ -21,6 +21,12 @@ public:
                 (end_point - _start_point);
     }
 
+    std::chrono::microseconds elapsed_microseconds() const {
+        const auto end_point { std::chrono::steady_clock::now() };
+        return std::chrono::duration_cast<std::chrono::microseconds>
+                (end_point - _start_point);
+    }
+
 private:
 
     std::chrono::time_point<std::chrono::steady_clock> _start_point;
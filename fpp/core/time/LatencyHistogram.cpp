@@ -0,0 +1,75 @@
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace fpp {
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::add(std::int64_t microseconds) {
+    const auto value { std::max(microseconds, std::int64_t { 0 }) };
+    auto bucket { std::size_t { 0 } };
+    while ((bucket < bucket_count - 1) && ((std::int64_t { 1 } << bucket) <= value)) {
+        ++bucket;
+    }
+    _buckets[bucket]++;
+    _count++;
+    _sum += value;
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+}
+
+void LatencyHistogram::reset() {
+    _buckets.fill(0);
+    _count = 0;
+    _sum   = 0;
+    _min   = std::numeric_limits<std::int64_t>::max();
+    _max   = 0;
+}
+
+std::int64_t LatencyHistogram::count() const {
+    return _count;
+}
+
+std::int64_t LatencyHistogram::min() const {
+    return _count ? _min : 0;
+}
+
+std::int64_t LatencyHistogram::max() const {
+    return _max;
+}
+
+std::int64_t LatencyHistogram::mean() const {
+    return _count ? _sum / _count : 0;
+}
+
+std::int64_t LatencyHistogram::percentile(double value) const {
+    if (_count == 0) {
+        return 0;
+    }
+    const auto threshold {
+        std::int64_t(double(_count) * std::clamp(value, 0.0, 1.0))
+    };
+    auto accumulated { std::int64_t { 0 } };
+    for (std::size_t i { 0 }; i < bucket_count; ++i) {
+        accumulated += _buckets[i];
+        if (accumulated >= threshold) {
+            return std::min(std::int64_t { 1 } << i, _max);
+        }
+    }
+    return _max;
+}
+
+std::string LatencyHistogram::toString() const {
+    /* n 250, min 410 us, mean 1730 us, p50 2048 us, p99 4096 us, max 3911 us */
+    return "n "       + std::to_string(count())            + ", "
+         + "min "     + std::to_string(min())              + " us, "
+         + "mean "    + std::to_string(mean())             + " us, "
+         + "p50 "     + std::to_string(percentile(0.50))   + " us, "
+         + "p99 "     + std::to_string(percentile(0.99))   + " us, "
+         + "max "     + std::to_string(max())              + " us";
+}
+
+} // namespace fpp
@@ -0,0 +1,40 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace fpp {
+
+/* Log2-bucketed histogram of latencies in microseconds */
+class LatencyHistogram {
+
+public:
+
+    LatencyHistogram();
+
+    void                add(std::int64_t microseconds);
+    void                reset();
+
+    std::int64_t        count() const;
+    std::int64_t        min()   const;
+    std::int64_t        max()   const;
+    std::int64_t        mean()  const;
+
+    /* returns upper bound of the bucket containing the percentile */
+    std::int64_t        percentile(double value) const;
+
+    std::string         toString() const;
+
+private:
+
+    static constexpr std::size_t bucket_count { 40 };
+
+    std::array<std::int64_t,bucket_count> _buckets;
+    std::int64_t        _count;
+    std::int64_t        _sum;
+    std::int64_t        _min;
+    std::int64_t        _max;
+
+};
+
+} // namespace fpp
@@ -0,0 +1,91 @@
+#include "LatencyTracer.hpp"
+
+namespace fpp {
+
+namespace {
+
+std::string hop_to_string(Trace::Hop hop) {
+    switch (hop) {
+        case Trace::Hop::Read:     return "read";
+        case Trace::Hop::Decode:   return "decode";
+        case Trace::Hop::Filter:   return "filter";
+        case Trace::Hop::Rescale:  return "rescale";
+        case Trace::Hop::Encode:   return "encode";
+        case Trace::Hop::Write:    return "write";
+        case Trace::Hop::EnumSize: break;
+    }
+    return "unknown";
+}
+
+} // namespace
+
+LatencyTracer::LatencyTracer()
+    : _enabled { false } {
+}
+
+LatencyTracer& LatencyTracer::instance() {
+    static LatencyTracer _tracer;
+    return _tracer;
+}
+
+void LatencyTracer::setEnabled(bool value) {
+    _enabled = value;
+}
+
+bool LatencyTracer::enabled() const {
+    return _enabled;
+}
+
+void LatencyTracer::record(const Trace& trace) {
+    if (trace.empty() || !trace.marked(Trace::Hop::Write)) {
+        return;
+    }
+    std::lock_guard lock { _mutex };
+    auto prev_stamp { trace.stamp(Trace::Hop::Read) };
+    for (auto i { std::size_t(Trace::Hop::Read) + 1 }; i < _hops.size(); ++i) {
+        const auto hop { Trace::Hop(i) };
+        if (!trace.marked(hop)) {
+            continue;
+        }
+        _hops[i].add(trace.stamp(hop) - prev_stamp);
+        prev_stamp = trace.stamp(hop);
+    }
+    _total.add(trace.stamp(Trace::Hop::Write) - trace.stamp(Trace::Hop::Read));
+}
+
+void LatencyTracer::reset() {
+    std::lock_guard lock { _mutex };
+    for (auto& histogram : _hops) {
+        histogram.reset();
+    }
+    _total.reset();
+}
+
+LatencyHistogram LatencyTracer::histogram(Trace::Hop hop) const {
+    std::lock_guard lock { _mutex };
+    return _hops[std::size_t(hop)];
+}
+
+LatencyHistogram LatencyTracer::total() const {
+    std::lock_guard lock { _mutex };
+    return _total;
+}
+
+std::string LatencyTracer::report() const {
+    std::lock_guard lock { _mutex };
+    std::string result;
+    for (auto i { std::size_t(Trace::Hop::Read) + 1 }; i < _hops.size(); ++i) {
+        if (_hops[i].count() == 0) {
+            continue;
+        }
+        result += hop_to_string(Trace::Hop(i)) + ": " + _hops[i].toString() + '\n';
+    }
+    result += "total: " + _total.toString();
+    return result;
+}
+
+void set_latency_tracing(bool enabled) {
+    LatencyTracer::instance().setEnabled(enabled);
+}
+
+} // namespace fpp
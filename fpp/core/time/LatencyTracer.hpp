@@ -0,0 +1,52 @@
+#pragma once
+#include <fpp/core/time/Trace.hpp>
+#include <fpp/core/time/LatencyHistogram.hpp>
+#include <atomic>
+#include <mutex>
+
+namespace fpp {
+
+/* Collects traces of the packets reaching the sink
+ * into per-hop latency histograms */
+class LatencyTracer {
+
+public:
+
+    static LatencyTracer& instance();
+
+    void                setEnabled(bool value);
+    bool                enabled() const;
+
+    void                record(const Trace& trace);
+    void                reset();
+
+    /* latency between the previous marked hop and the given one */
+    LatencyHistogram    histogram(Trace::Hop hop) const;
+    /* latency between Read and Write */
+    LatencyHistogram    total() const;
+
+    std::string         report() const;
+
+private:
+
+    LatencyTracer();
+
+    LatencyTracer(const LatencyTracer&)            = delete;
+    LatencyTracer(LatencyTracer&&)                 = delete;
+    LatencyTracer& operator=(const LatencyTracer&) = delete;
+    LatencyTracer& operator=(LatencyTracer&&)      = delete;
+
+private:
+
+    using HistogramArray = std::array<LatencyHistogram,std::size_t(Trace::Hop::EnumSize)>;
+
+    std::atomic_bool    _enabled;
+    mutable std::mutex  _mutex;
+    HistogramArray      _hops;
+    LatencyHistogram    _total;
+
+};
+
+void set_latency_tracing(bool enabled);
+
+} // namespace fpp
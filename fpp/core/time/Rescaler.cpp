@@ -0,0 +1,107 @@
+#include "Rescaler.hpp"
+#include <limits>
+#include <numeric>
+
+extern "C" {
+    #include <libavcodec/avcodec.h>
+}
+
+namespace fpp {
+
+Rescaler::Rescaler()
+    : _from { 0, 1 }
+    , _to { 0, 1 }
+    , _kind { Kind::Identity }
+    , _factor { 1 }
+    , _shift { 0 }
+    , _limit { std::numeric_limits<std::int64_t>::max() } {
+}
+
+Rescaler::Rescaler(AVRational from, AVRational to)
+    : _from { from }
+    , _to { to }
+    , _kind { Kind::Generic }
+    , _factor { 1 }
+    , _shift { 0 }
+    , _limit { 0 } {
+    if ((from.num <= 0) || (from.den <= 0) || (to.num <= 0) || (to.den <= 0)) {
+        return;
+    }
+    /* value * num / den, reducing the ratio does not change the rounding */
+    auto num { std::int64_t { from.num } * to.den };
+    auto den { std::int64_t { from.den } * to.num };
+    const auto divisor { std::gcd(num, den) };
+    num /= divisor;
+    den /= divisor;
+
+    constexpr auto max { std::numeric_limits<std::int64_t>::max() };
+    const auto power_of_two { [](std::int64_t x) { return (x & (x - 1)) == 0; } };
+    /* runs once per pair, no compiler specific bit scan needed */
+    const auto trailing_zeros {
+        [](std::int64_t x) {
+            auto count { 0 };
+            while ((x & 1) == 0) {
+                x >>= 1;
+                ++count;
+            }
+            return count;
+        }
+    };
+    if (num == den) {
+        _kind = Kind::Identity;
+        _limit = max;
+    } else if (den == 1) {
+        if (power_of_two(num)) {
+            _kind = Kind::ShiftLeft;
+            _shift = trailing_zeros(num);
+            _limit = max >> _shift;
+        } else {
+            _kind = Kind::Multiply;
+            _factor = num;
+            _limit = max / num;
+        }
+    } else if (num == 1) {
+        if (power_of_two(den)) {
+            _kind = Kind::ShiftRight;
+            _shift = trailing_zeros(den);
+        } else {
+            _kind = Kind::Divide;
+            _factor = den;
+        }
+        _limit = max - den / 2;
+    }
+}
+
+void Rescaler::rescale(AVPacket* packet) const {
+    if (_kind == Kind::Identity) {
+        return;
+    }
+    if (packet->pts != AV_NOPTS_VALUE) {
+        packet->pts = (*this)(packet->pts);
+    }
+    if (packet->dts != AV_NOPTS_VALUE) {
+        packet->dts = (*this)(packet->dts);
+    }
+    if (packet->duration > 0) {
+        packet->duration = (*this)(packet->duration);
+    }
+}
+
+bool Rescaler::converts(AVRational from, AVRational to) const {
+    return (_from.num == from.num) && (_from.den == from.den)
+        && (_to.num == to.num) && (_to.den == to.den);
+}
+
+AVRational Rescaler::from() const {
+    return _from;
+}
+
+AVRational Rescaler::to() const {
+    return _to;
+}
+
+bool Rescaler::identity() const {
+    return _kind == Kind::Identity;
+}
+
+} // namespace fpp
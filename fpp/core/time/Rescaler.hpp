@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+
+extern "C" {
+    #include <libavutil/mathematics.h>
+}
+
+struct AVPacket;
+
+namespace fpp {
+
+/* av_rescale_q for a fixed pair of time bases. The ratio is reduced
+ * once, exact integer ratios (1/1000 -> 1/90000, 1/44100 -> 1/88200)
+ * become a multiply or a shift and exact divisors a rounded division,
+ * everything else and overflowing values go to av_rescale_q.
+ * Results are identical to av_rescale_q (round to nearest, half away
+ * from zero) */
+class Rescaler {
+
+public:
+
+    Rescaler();
+    Rescaler(AVRational from, AVRational to);
+
+    std::int64_t operator()(std::int64_t value) const {
+        switch (_kind) {
+        case Kind::Identity:
+            return value;
+        case Kind::Multiply:
+            if ((value <= _limit) && (value >= -_limit)) {
+                return value * _factor;
+            }
+            break;
+        case Kind::ShiftLeft:
+            if ((value <= _limit) && (value >= -_limit)) {
+                return value * (std::int64_t { 1 } << _shift);
+            }
+            break;
+        case Kind::Divide:
+            if ((value <= _limit) && (value >= -_limit)) {
+                return value >= 0
+                    ?  ((value + _factor / 2) / _factor)
+                    : -((_factor / 2 - value) / _factor);
+            }
+            break;
+        case Kind::ShiftRight:
+            if ((value <= _limit) && (value >= -_limit)) {
+                const auto half { std::int64_t { 1 } << (_shift - 1) };
+                return value >= 0
+                    ?  ((value + half) >> _shift)
+                    : -((half - value) >> _shift);
+            }
+            break;
+        case Kind::Generic:
+            break;
+        }
+        return ::av_rescale_q(value, _from, _to);
+    }
+
+    /* pts, dts and duration like av_packet_rescale_ts */
+    void                rescale(AVPacket* packet) const;
+
+    /* true if built for this pair, cheaper than av_cmp_q */
+    bool                converts(AVRational from, AVRational to) const;
+
+    AVRational          from()      const;
+    AVRational          to()        const;
+    bool                identity()  const;
+
+private:
+
+    enum class Kind : std::uint8_t {
+          Identity
+        , Multiply      ///< value * factor
+        , ShiftLeft     ///< value << shift
+        , Divide        ///< value / factor, rounded
+        , ShiftRight    ///< value >> shift, rounded
+        , Generic       ///< av_rescale_q
+    };
+
+private:
+
+    AVRational          _from;
+    AVRational          _to;
+    Kind                _kind;
+    std::int64_t        _factor;
+    int                 _shift;
+    std::int64_t        _limit;     ///< max magnitude handled without av_rescale_q
+
+};
+
+} // namespace fpp
@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+namespace fpp {
+
+/* Per-packet/per-frame latency trace:
+ * steady clock stamps (in microseconds) of every hop
+ * a media unit has passed through since it was read */
+class Trace {
+
+public:
+
+    enum class Hop : std::uint8_t {
+          Read
+        , Decode
+        , Filter
+        , Rescale
+        , Encode
+        , Write
+        , EnumSize
+    };
+
+    Trace() {
+        _stamps.fill(not_marked);
+    }
+
+    void mark(Hop hop) {
+        _stamps[std::size_t(hop)] = now();
+    }
+
+    bool marked(Hop hop) const {
+        return _stamps[std::size_t(hop)] != not_marked;
+    }
+
+    std::int64_t stamp(Hop hop) const {
+        return _stamps[std::size_t(hop)];
+    }
+
+    bool empty() const {
+        return !marked(Hop::Read);
+    }
+
+    static Trace begin() {
+        Trace trace;
+        trace.mark(Hop::Read);
+        return trace;
+    }
+
+    static std::int64_t now() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+private:
+
+    static constexpr std::int64_t not_marked { -1 };
+
+    std::array<std::int64_t,std::size_t(Hop::EnumSize)> _stamps;
+
+};
+
+/* Frame stores the trace as raw bytes in AVFrame::opaque_ref */
+static_assert(std::is_trivially_copyable_v<Trace>);
+
+} // namespace fpp
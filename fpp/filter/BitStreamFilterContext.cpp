@@ -1,5 +1,6 @@
 #include "BitStreamFilterContext.hpp"
 #include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/Utils.hpp>
 
 extern "C" {
     #include <libavcodec/avcodec.h>
@@ -7,26 +8,32 @@ extern "C" {
 
 namespace fpp {
 
-BitStreamFilterContext::BitStreamFilterContext(const fpp::SpParameters param, const std::string_view filter_name) {
+BitStreamFilterContext::BitStreamFilterContext(const fpp::SpParameters param, const std::string_view filter_name)
+    : _type { param->type() } {
     reset(
         [&]() {
-            const auto bfs {
-                ::av_bsf_get_by_name(filter_name.data())
-            };
-            if (!bfs) {
+            /* a single filter is a chain of one, an empty name
+             * gives the null filter which passes packets through */
+            AVBSFContext* bfs_ctx { nullptr };
+            if (const auto ret {
+                    ::av_bsf_list_parse_str(std::string { filter_name }.c_str(), &bfs_ctx)
+                }; ret < 0) {
                 throw FFmpegException {
-                    "No such bitstream filter exists: "
+                    "Failed to create bitstream filter: "
                     + std::string { filter_name }
                 };
             }
 
-            AVBSFContext* bfs_ctx { nullptr };
-            ffmpeg_api_strict(::av_bsf_alloc, bfs, &bfs_ctx);
-
             param->initCodecpar(bfs_ctx->par_in);
             bfs_ctx->time_base_in = param->timeBase();
 
-            ffmpeg_api_strict(::av_bsf_init, bfs_ctx); // TODO: memory leak on failure (28.04)
+            if (const auto ret { ::av_bsf_init(bfs_ctx) }; ret < 0) {
+                ::av_bsf_free(&bfs_ctx);
+                throw FFmpegException {
+                    "Failed to init bitstream filter: "
+                    + std::string { filter_name }
+                };
+            }
             return bfs_ctx;
         }()
         , [](AVBSFContext* ctx) {
@@ -36,12 +43,57 @@ BitStreamFilterContext::BitStreamFilterContext(const fpp::SpParameters param, co
     );
 }
 
-Packet BitStreamFilterContext::filter(Packet packet) {
-    Packet filtered_packet { packet.type() };
-    filtered_packet.setTimeBase(packet.timeBase());
-    ffmpeg_api_strict(::av_bsf_send_packet,    raw(), packet.ptr()         );
-    ffmpeg_api_strict(::av_bsf_receive_packet, raw(), filtered_packet.ptr());
-    return filtered_packet;
+PacketVector BitStreamFilterContext::filter(const Packet& packet) {
+    return filter(Packet { packet });
+}
+
+PacketVector BitStreamFilterContext::filter(Packet&& packet) {
+    PacketVector filtered_packets;
+    /* the filter takes ownership of the packet's data */
+    while (true) {
+        const auto ret { ::av_bsf_send_packet(raw(), packet.ptr()) };
+        if (ret == 0) {
+            break;
+        }
+        if (ret != ERROR_AGAIN) {
+            throw FFmpegException { "av_bsf_send_packet failed" };
+        }
+        /* output is full: drain it and send again */
+        auto pending { receivePackets() };
+        if (pending.empty()) {
+            throw FFmpegException { "av_bsf_send_packet would block" };
+        }
+        std::move(pending.begin(), pending.end(), std::back_inserter(filtered_packets));
+    }
+    auto received { receivePackets() };
+    std::move(received.begin(), received.end(), std::back_inserter(filtered_packets));
+    return filtered_packets;
+}
+
+PacketVector BitStreamFilterContext::flush() {
+    ffmpeg_api_strict(::av_bsf_send_packet, raw(), nullptr);
+    return receivePackets();
+}
+
+AVRational BitStreamFilterContext::timeBaseOut() const {
+    return raw()->time_base_out;
+}
+
+PacketVector BitStreamFilterContext::receivePackets() {
+    PacketVector filtered_packets;
+    while (true) {
+        Packet filtered_packet { _type };
+        const auto ret { ::av_bsf_receive_packet(raw(), filtered_packet.ptr()) };
+        if ((ret == ERROR_AGAIN) || (ret == ERROR_EOF)) {
+            break; /* not an error - just an exit code */
+        }
+        if (ret < 0) {
+            throw FFmpegException { "av_bsf_receive_packet failed" };
+        }
+        filtered_packet.setTimeBase(timeBaseOut());
+        filtered_packets.push_back(std::move(filtered_packet));
+    }
+    return filtered_packets;
 }
 
 } // namespace fpp
@@ -11,9 +11,25 @@ class BitStreamFilterContext : public SharedFFmpegObject<AVBSFContext> {
 
 public:
 
+    /* filter_name is a single filter or a comma separated chain with
+     * options, e.g. "h264_metadata=aud=insert,h264_mp4toannexb" */
     BitStreamFilterContext(const fpp::SpParameters param, const std::string_view filter_name);
 
-    Packet              filter(Packet packet);
+    /* a filter may emit no packets or several per input packet */
+    PacketVector        filter(const Packet& packet);
+    PacketVector        filter(Packet&& packet);
+    /* drains packets buffered by the chain at end of stream */
+    PacketVector        flush();
+
+    AVRational          timeBaseOut() const;
+
+private:
+
+    PacketVector        receivePackets();
+
+private:
+
+    const Media::Type   _type;
 
 };
 
@@ -6,17 +6,22 @@ ComplexFilterGraph::ComplexFilterGraph(const Options& options)
     : FilterGraph(options) {
 }
 
+ComplexFilterGraph::ComplexFilterGraph(const FilterThreading& threading, const Options& options)
+    : FilterGraph(threading, options) {
+}
+
 std::size_t ComplexFilterGraph::createInputFilterChain(const SpParameters par, const std::vector<std::string>& filters) {
     FilterChain chain { par->type() };
-    chain.add(createBufferSource(par));
-    chain.add(createFilterContexts(filters));
+    const auto tmpl { compile(par, filters) };
+    chain.add(createBufferSource(par, *tmpl));
+    chain.add(createFilterContexts(*tmpl));
     chain.linkFilters();
     return emplaceFilterChainBack(chain);
 }
 
 std::size_t ComplexFilterGraph::createOutputFilterChain(const SpParameters par, const std::vector<std::string>& filters) {
     FilterChain chain { par->type() };
-    chain.add(createFilterContexts(filters));
+    chain.add(createFilterContexts(*compile(par, filters)));
     chain.add(createBufferSink(par));
     chain.linkFilters();
     return emplaceFilterChainBack(chain);
@@ -24,7 +29,7 @@ std::size_t ComplexFilterGraph::createOutputFilterChain(const SpParameters par,
 
 std::size_t ComplexFilterGraph::createFilterChain(const SpParameters par, const std::vector<std::string>& filters) {
     FilterChain chain { par->type() };
-    chain.add(createFilterContexts(filters));
+    chain.add(createFilterContexts(*compile(par, filters)));
     chain.linkFilters();
     return emplaceFilterChainBack(chain);
 }
@@ -41,6 +46,10 @@ void ComplexFilterGraph::write(const Frame& frame, std::size_t input_chain_index
     chain(input_chain_index).write(frame);
 }
 
+void ComplexFilterGraph::write(Frame&& frame, std::size_t input_chain_index, bool push) {
+    chain(input_chain_index).write(std::move(frame), push);
+}
+
 FrameVector ComplexFilterGraph::read(std::size_t output_chain_index) {
     return chain(output_chain_index).read();
 }
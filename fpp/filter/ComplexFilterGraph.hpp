@@ -12,6 +12,7 @@ class ComplexFilterGraph : public FilterGraph {
 public:
 
     explicit ComplexFilterGraph(const Options& options = {});
+    explicit ComplexFilterGraph(const FilterThreading& threading, const Options& options = {});
 
     std::size_t         createInputFilterChain (const SpParameters par, const std::vector<std::string>& filters);
     std::size_t         createOutputFilterChain(const SpParameters par, const std::vector<std::string>& filters);
@@ -20,6 +21,7 @@ public:
     void                link(const std::vector<std::size_t>& in, const std::vector<std::size_t>& out);
 
     void                write(const Frame& frame, std::size_t input_chain_index);
+    void                write(Frame&& frame, std::size_t input_chain_index, bool push = false);
     FrameVector         read(std::size_t output_chain_index);
 
 };
@@ -0,0 +1,144 @@
+#include "FrameSynchronizer.hpp"
+#include <fpp/core/Utils.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace fpp {
+
+FrameSynchronizer::FrameSynchronizer(ComplexFilterGraph& graph
+                                   , std::vector<std::size_t> input_chains
+                                   , std::int64_t max_skew
+                                   , std::size_t max_depth)
+    : _graph { graph }
+    , _max_skew { max_skew }
+    , _max_depth { std::max(max_depth, std::size_t { 1 }) } {
+    _inputs.resize(input_chains.size());
+    for (std::size_t i { 0 }; i < input_chains.size(); ++i) {
+        _inputs[i].chain = input_chains[i];
+    }
+}
+
+std::size_t FrameSynchronizer::push(std::size_t input, const Frame& frame) {
+    auto& in { _inputs.at(input) };
+    /* frames without pts keep their input's position */
+    const auto time {
+        frame.pts() == NOPTS_VALUE
+            ? (in.last_time == NOPTS_VALUE ? 0 : in.last_time)
+            : ::av_rescale_q(frame.pts(), frame.timeBase(), DEFAULT_TIME_BASE)
+    };
+    in.queue.emplace_back(time, frame);
+    in.last_time = std::max(in.last_time, time);
+    return release();
+}
+
+std::size_t FrameSynchronizer::finish(std::size_t input) {
+    _inputs.at(input).finished = true;
+    return release();
+}
+
+std::size_t FrameSynchronizer::nextInput() const {
+    std::size_t next { 0 };
+    auto behind { std::numeric_limits<std::int64_t>::max() };
+    for (std::size_t i { 0 }; i < _inputs.size(); ++i) {
+        const auto& in { _inputs[i] };
+        if (in.finished) {
+            continue;
+        }
+        /* an input that delivered nothing yet is the furthest behind */
+        const auto time {
+            in.last_time == NOPTS_VALUE ? std::numeric_limits<std::int64_t>::min() : in.last_time
+        };
+        if (time < behind) {
+            behind = time;
+            next = i;
+        }
+    }
+    return next;
+}
+
+bool FrameSynchronizer::canAccept(std::size_t input) const {
+    const auto& in { _inputs.at(input) };
+    if (in.queue.size() >= _max_depth) {
+        return false;
+    }
+    if (in.last_time == NOPTS_VALUE) {
+        return true;
+    }
+    for (const auto& other : _inputs) {
+        if (!other.finished && (other.last_time != NOPTS_VALUE)
+                && (in.last_time - other.last_time > _max_skew)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FrameSynchronizer::finished() const {
+    return std::all_of(_inputs.begin(), _inputs.end()
+        , [](const auto& in) { return in.finished && in.queue.empty(); });
+}
+
+std::size_t FrameSynchronizer::depth(std::size_t input) const {
+    return _inputs.at(input).queue.size();
+}
+
+std::size_t FrameSynchronizer::depth() const {
+    std::size_t total { 0 };
+    for (const auto& in : _inputs) {
+        total += in.queue.size();
+    }
+    return total;
+}
+
+std::size_t FrameSynchronizer::release() {
+    std::size_t released { 0 };
+    while (true) {
+        /* earliest queued frame over all inputs */
+        auto earliest { _inputs.size() };
+        for (std::size_t i { 0 }; i < _inputs.size(); ++i) {
+            const auto& in { _inputs[i] };
+            if (!in.queue.empty() && ((earliest == _inputs.size())
+                    || (in.queue.front().first < _inputs[earliest].queue.front().first))) {
+                earliest = i;
+            }
+        }
+        if (earliest == _inputs.size()) {
+            break;
+        }
+        auto& in { _inputs[earliest] };
+        if (!releasable(earliest, in.queue.front().first)) {
+            break;
+        }
+        _graph.write(std::move(in.queue.front().second), in.chain);
+        in.queue.pop_front();
+        released++;
+    }
+    return released;
+}
+
+bool FrameSynchronizer::releasable(std::size_t input, std::int64_t time) const {
+    if (_inputs[input].queue.size() >= _max_depth) {
+        log_warning() << "Input #" << input << " reached max depth " << _max_depth
+                      << ", releasing without the other inputs";
+        return true;
+    }
+    for (std::size_t i { 0 }; i < _inputs.size(); ++i) {
+        const auto& other { _inputs[i] };
+        if ((i == input) || other.finished || !other.queue.empty()) {
+            continue;
+        }
+        /* nothing from it yet, wait until max depth forces the release */
+        if (other.last_time == NOPTS_VALUE) {
+            return false;
+        }
+        /* its next frame can't be earlier than its last one,
+         * and beyond the max skew it is not waited for */
+        const auto lead { time - other.last_time };
+        if ((lead > 0) && (lead <= _max_skew)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace fpp
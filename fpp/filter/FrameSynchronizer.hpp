@@ -0,0 +1,58 @@
+#pragma once
+#include <fpp/filter/ComplexFilterGraph.hpp>
+#include <fpp/core/Utils.hpp>
+#include <deque>
+
+namespace fpp {
+
+/* Feeds the input chains of a ComplexFilterGraph in timestamp order.
+ * A frame is released once no other active input can still deliver
+ * an earlier one, or once it leads the slowest input by more than
+ * max_skew (ms). nextInput() and canAccept() tell the caller which
+ * source to read next, which keeps a fast source from running ahead
+ * and bounds the buffered depth per input */
+class FrameSynchronizer : public Object {
+
+public:
+
+    FrameSynchronizer(ComplexFilterGraph& graph
+                    , std::vector<std::size_t> input_chains
+                    , std::int64_t max_skew = 500
+                    , std::size_t max_depth = 64);
+
+    /* queues the frame of input (index in input_chains),
+     * returns the number of frames written to the graph */
+    std::size_t         push(std::size_t input, const Frame& frame);
+    /* input has ended, it no longer holds the others back */
+    std::size_t         finish(std::size_t input);
+
+    /* unfinished input furthest behind, the one to read next */
+    std::size_t         nextInput() const;
+    bool                canAccept(std::size_t input) const;
+    bool                finished() const;
+
+    std::size_t         depth(std::size_t input) const;
+    std::size_t         depth() const;
+
+private:
+
+    struct Input {
+        std::size_t     chain;
+        std::deque<std::pair<std::int64_t,Frame>> queue;
+        std::int64_t    last_time { NOPTS_VALUE };
+        bool            finished  { false };
+    };
+
+    std::size_t         release();
+    bool                releasable(std::size_t input, std::int64_t time) const;
+
+private:
+
+    ComplexFilterGraph& _graph;
+    const std::int64_t  _max_skew;
+    const std::size_t   _max_depth;
+    std::vector<Input>  _inputs;
+
+};
+
+} // namespace fpp
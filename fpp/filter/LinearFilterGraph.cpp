@@ -4,9 +4,19 @@ namespace fpp {
 
 LinearFilterGraph::LinearFilterGraph(const SpParameters par, const std::vector<std::string>& filters, const Options& options)
     : FilterGraph(options) {
+    createChain(par, filters);
+}
+
+LinearFilterGraph::LinearFilterGraph(const SpParameters par, const std::vector<std::string>& filters, const FilterThreading& threading, const Options& options)
+    : FilterGraph(threading, options) {
+    createChain(par, filters);
+}
+
+void LinearFilterGraph::createChain(const SpParameters par, const std::vector<std::string>& filters) {
     FilterChain chain { par->type() };
-    chain.add(createBufferSource(par));
-    chain.add(createFilterContexts(filters));
+    const auto tmpl { compile(par, filters) };
+    chain.add(createBufferSource(par, *tmpl));
+    chain.add(createFilterContexts(*tmpl));
     chain.add(createBufferSink(par));
     chain.linkFilters();
     emplaceFilterChainBack(chain);
@@ -18,4 +28,14 @@ FrameVector LinearFilterGraph::filter(const Frame& frame) {
     return chain(0).read();
 }
 
+FrameVector LinearFilterGraph::filter(Frame&& frame) {
+    chain(0).write(std::move(frame), true);
+    return chain(0).read();
+}
+
+FrameVector LinearFilterGraph::filter(FrameVector&& frames) {
+    chain(0).write(std::move(frames), true);
+    return chain(0).read();
+}
+
 } // namespace fpp
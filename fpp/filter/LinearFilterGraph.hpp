@@ -12,8 +12,15 @@ class LinearFilterGraph : public FilterGraph {
 public:
 
     LinearFilterGraph(const SpParameters par, const std::vector<std::string>& filters, const Options& options = {});
+    LinearFilterGraph(const SpParameters par, const std::vector<std::string>& filters, const FilterThreading& threading, const Options& options = {});
 
     FrameVector         filter(const Frame& frame);
+    FrameVector         filter(Frame&& frame);
+    FrameVector         filter(FrameVector&& frames);
+
+private:
+
+    void                createChain(const SpParameters par, const std::vector<std::string>& filters);
 
 };
 
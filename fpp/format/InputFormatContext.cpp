@@ -1,6 +1,11 @@
 #include "InputFormatContext.hpp"
 #include <fpp/core/Utils.hpp>
 #include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/time/LatencyTracer.hpp>
+#include <fpp/core/AllocationTracker.hpp>
+#include <fpp/codec/DecoderContext.hpp>
+#include <algorithm>
+#include <iterator>
 
 extern "C" {
     #include <libavformat/avformat.h>
@@ -8,14 +13,57 @@ extern "C" {
 
 namespace fpp {
 
+namespace {
+
+/* packets of other streams kept by seekPrecise, the oldest are dropped
+ * above it so a target past the end of a stream cannot buffer the
+ * rest of the file */
+constexpr std::size_t max_pending_packets { 1024 };
+
+/* restores the caller's skip_frame however seekPrecise leaves */
+class SkipFrameRestorer {
+
+public:
+
+    explicit SkipFrameRestorer(AVCodecContext* codec_ctx)
+        : _codec_ctx { codec_ctx }
+        , _skip_frame { codec_ctx->skip_frame } {
+    }
+
+    ~SkipFrameRestorer() {
+        _codec_ctx->skip_frame = _skip_frame;
+    }
+
+    SkipFrameRestorer(const SkipFrameRestorer&) = delete;
+    SkipFrameRestorer& operator=(const SkipFrameRestorer&) = delete;
+
+    AVDiscard value() const {
+        return _skip_frame;
+    }
+
+private:
+
+    AVCodecContext* const _codec_ctx;
+    const AVDiscard _skip_frame;
+
+};
+
+} // namespace
+
 InputFormatContext::InputFormatContext(const std::string_view mrl, const std::string_view format)
-    : _input_format { findInputFormat(format) } {
+    : _input_format { findInputFormat(format) }
+    , _start_point_pending { false }
+    , _keyframe_indexing { false }
+    , _persist_keyframe_index { false } {
     setMediaResourceLocator(mrl);
     createContext();
 }
 
 InputFormatContext::InputFormatContext(InputContext* input_ctx, const std::string_view format)
-    : _input_format { findInputFormat(format) } {
+    : _input_format { findInputFormat(format) }
+    , _start_point_pending { false }
+    , _keyframe_indexing { false }
+    , _persist_keyframe_index { false } {
     setMediaResourceLocator("Custom input buffer");
     createContext();
     raw()->pb = input_ctx->raw();
@@ -45,22 +93,109 @@ bool InputFormatContext::seek(int stream_index, std::int64_t timestamp, SeekPrec
         }()
     };
     ffmpeg_api_non_strict(av_seek_frame, raw(), stream_index, timestamp, flags);
+    _pending_packets.clear();
+    /* an explicit seek replaces the start point */
+    _start_point_pending = false;
     log_info() << "Success seek to " << utils::time_to_string(timestamp, DEFAULT_TIME_BASE);
     return true;
 }
 
 Packet InputFormatContext::read() {
-    setInterruptTimeout(getTimeout(TimeoutProcess::Reading));
-    auto packet { readFromSource() };
+    FPP_ALLOCATION_SCOPE(Read);
+    if (_start_point_pending) {
+        seekToStartPoint();
+    }
+    const auto packet_read {
+        [this]() {
+            if (!_pending_packets.empty()) {
+                auto pending { std::move(_pending_packets.front()) };
+                _pending_packets.pop_front();
+                return pending;
+            }
+            setInterruptTimeout(getTimeout(TimeoutProcess::Reading));
+            return readFromSource();
+        }
+    };
+    auto packet { packet_read() };
     if (packet.isEOF()) {
         return packet;
     }
     if (!processPacket(packet)) {
         return Packet { Media::Type::EndOF };
     }
+    if (LatencyTracer::instance().enabled()) {
+        packet.setTrace(Trace::begin());
+    }
     return packet;
 }
 
+void InputFormatContext::setKeyframeIndexing(bool enabled, bool persist) {
+    _keyframe_indexing = enabled;
+    _persist_keyframe_index = persist;
+}
+
+const KeyframeIndex& InputFormatContext::keyframeIndex() const {
+    return _keyframe_index;
+}
+
+FrameVector InputFormatContext::seekPrecise(DecoderContext& decoder, int stream_index, std::int64_t timestamp) {
+    _pending_packets.clear();
+    if (!seekToKeyframe(stream_index, timestamp)) {
+        return {};
+    }
+    /* an explicit seek replaces the start point */
+    _start_point_pending = false;
+    decoder.flushBuffers();
+
+    const auto time_base { raw()->streams[stream_index]->time_base };
+    const auto type { stream(std::size_t(stream_index))->type() };
+
+    /* non-reference frames before the target are neither shown nor
+     * needed to decode it, so the decoder may skip them entirely */
+    const SkipFrameRestorer restorer { decoder.raw() };
+    const auto skip_frame { restorer.value() };
+    const auto skip_before_target { std::max(skip_frame, AVDISCARD_NONREF) };
+
+    FrameVector result;
+    while (result.empty()) {
+        setInterruptTimeout(getTimeout(TimeoutProcess::Reading));
+        auto packet { readFromSource() };
+        FrameVector frames;
+        if (packet.isEOF()) {
+            decoder.raw()->skip_frame = skip_frame;
+            frames = decoder.flush(time_base, stream_index);
+        } else {
+            if (packet.streamIndex() != stream_index) {
+                if (_pending_packets.size() == max_pending_packets) {
+                    log_warning() << "Too many packets read before the seek target, dropping the oldest";
+                    _pending_packets.pop_front();
+                }
+                _pending_packets.push_back(std::move(packet));
+                continue;
+            }
+            packet.setTimeBase(time_base);
+            packet.setType(type);
+            const auto before_target {
+                (packet.pts() != AV_NOPTS_VALUE) && (packet.pts() < timestamp)
+            };
+            decoder.raw()->skip_frame = before_target ? skip_before_target : skip_frame;
+            frames = decoder.decode(packet);
+        }
+        /* the decoder output is in presentation order, everything
+         * from the target on belongs to the caller */
+        const auto target {
+            std::find_if(frames.begin(), frames.end(), [timestamp](const Frame& frame) {
+                return frame.raw().best_effort_timestamp >= timestamp;
+            })
+        };
+        std::move(target, frames.end(), std::back_inserter(result));
+        if (packet.isEOF()) {
+            break;
+        }
+    }
+    return result;
+}
+
 void InputFormatContext::createContext() {
     reset(
         [&]() {
@@ -93,6 +228,10 @@ bool InputFormatContext::openContext(const Options& options) {
 
     setInputFormat(raw()->iformat);
     retrieveStreams(options);
+    _start_point_pending = true;
+    if (_keyframe_indexing) {
+        loadKeyframeIndex();
+    }
     return true;
 }
 
@@ -101,7 +240,9 @@ std::string InputFormatContext::formatName() const {
 }
 
 void InputFormatContext::closeContext() {
+    _pending_packets.clear();
     reset();
+    _keyframe_index.clear();
     setInputFormat(nullptr);
 }
 
@@ -165,4 +306,108 @@ Packet InputFormatContext::readFromSource() {
     return packet;
 }
 
+void InputFormatContext::seekToStartPoint() {
+    _start_point_pending = false;
+    std::int64_t start_point { TO_END };
+    for (const auto& input_stream : streams()) {
+        if (input_stream->startTimePoint() != FROM_START) {
+            start_point = std::min(start_point, input_stream->startTimePoint());
+        }
+    }
+    if (start_point == TO_END) {
+        return;
+    }
+    const auto start_time {
+        raw()->start_time != AV_NOPTS_VALUE ? raw()->start_time : 0
+    };
+    /* backward seek lands on the preceding keyframe, so whole gops are read */
+    ffmpeg_api_strict(av_seek_frame
+        , raw()
+        , -1
+        , start_time + ::av_rescale_q(start_point, DEFAULT_TIME_BASE, AV_TIME_BASE_Q)
+        , AVSEEK_FLAG_BACKWARD
+    );
+    log_info() << "Seek to start point " << utils::time_to_string(start_point, DEFAULT_TIME_BASE);
+}
+
+std::string InputFormatContext::keyframeIndexPath() const {
+    return mediaResourceLocator() + ".fppidx";
+}
+
+void InputFormatContext::loadKeyframeIndex() {
+    const auto source_size {
+        raw()->pb ? ::avio_size(raw()->pb) : std::int64_t { -1 }
+    };
+    if (source_size < 0) {
+        log_warning() << "Keyframe index requires a seekable source";
+        return;
+    }
+    const auto path { keyframeIndexPath() };
+    if (_persist_keyframe_index && _keyframe_index.load(path, source_size)) {
+        log_info() << "Keyframe index loaded from " << utils::quoted(path);
+        return;
+    }
+    buildKeyframeIndex();
+    if (_persist_keyframe_index && !_keyframe_index.save(path, source_size)) {
+        log_warning() << "Failed to save keyframe index to " << utils::quoted(path);
+    }
+}
+
+void InputFormatContext::buildKeyframeIndex() {
+    _keyframe_index.clear();
+
+    /* every audio packet is a keyframe, index video streams only */
+    std::vector<AVDiscard> discards;
+    for (auto i { 0u }; i < raw()->nb_streams; ++i) {
+        const auto av_stream { raw()->streams[i] };
+        discards.push_back(av_stream->discard);
+        if (av_stream->codecpar->codec_type != AVMEDIA_TYPE_VIDEO) {
+            av_stream->discard = AVDISCARD_ALL;
+        }
+    }
+
+    while (true) {
+        setInterruptTimeout(getTimeout(TimeoutProcess::Reading));
+        const auto packet { readFromSource() };
+        if (packet.isEOF()) {
+            break;
+        }
+        if (!packet.keyFrame()) {
+            continue;
+        }
+        const auto pts {
+            packet.pts() != AV_NOPTS_VALUE ? packet.pts() : packet.dts()
+        };
+        if (pts != AV_NOPTS_VALUE) {
+            _keyframe_index.add(packet.streamIndex(), { pts, packet.pos() });
+        }
+    }
+
+    for (auto i { 0u }; i < raw()->nb_streams; ++i) {
+        raw()->streams[i]->discard = discards[i];
+    }
+
+    const auto start_time {
+        raw()->start_time != AV_NOPTS_VALUE ? raw()->start_time : 0
+    };
+    ffmpeg_api_strict(av_seek_frame, raw(), -1, start_time, AVSEEK_FLAG_BACKWARD);
+    log_info() << "Keyframe index built";
+}
+
+bool InputFormatContext::seekToKeyframe(int stream_index, std::int64_t timestamp) {
+    const auto keyframe {
+        _keyframe_index.findPreceding(stream_index, timestamp)
+    };
+    if (!keyframe) {
+        return seek(stream_index, timestamp, SeekPrecision::Backward);
+    }
+    /* timestamps of such formats are unreliable for seeking (as in ffplay) */
+    if ((keyframe->pos >= 0) && (inputFormat()->flags & AVFMT_TS_DISCONT)) {
+        ffmpeg_api_non_strict(av_seek_frame, raw(), stream_index, keyframe->pos, AVSEEK_FLAG_BYTE);
+        return true;
+    }
+    ffmpeg_api_non_strict(av_seek_frame, raw(), stream_index, keyframe->pts, AVSEEK_FLAG_BACKWARD);
+    return true;
+}
+
 } // namespace fpp
@@ -1,9 +1,14 @@
 #pragma once
 #include <fpp/base/FormatContext.hpp>
 #include <fpp/format/InputContext.hpp>
+#include <fpp/format/KeyframeIndex.hpp>
+#include <fpp/base/Frame.hpp>
+#include <deque>
 
 namespace fpp {
 
+class DecoderContext;
+
 class InputFormatContext : public FormatContext {
 
 public:
@@ -24,6 +29,19 @@ public:
     bool                seek(int stream_index, std::int64_t timestamp, SeekPrecision seek_precision = SeekPrecision::Forward);
     Packet              read();
 
+    /* builds the keyframe index on open, persist loads and
+     * saves it next to the source (mrl + ".fppidx") */
+    void                setKeyframeIndexing(bool enabled, bool persist = false);
+    const KeyframeIndex& keyframeIndex() const;
+
+    /* seeks to the nearest preceding keyframe and decodes forward,
+     * returns the first frame at or after timestamp (stream time base)
+     * followed by the frames decoded with it, empty if not found;
+     * frames before it are dropped without conversion, packets of other
+     * streams read meanwhile are returned by the next read() calls,
+     * up to 1024 of them, older ones are dropped */
+    FrameVector         seekPrecise(DecoderContext& decoder, int stream_index, std::int64_t timestamp);
+
 private:
 
     void                createContext() override;
@@ -37,11 +55,24 @@ private:
     AVInputFormat*      findInputFormat(const std::string_view short_name) const;
 
     Packet              readFromSource();
+    void                seekToStartPoint();
+
+    std::string         keyframeIndexPath() const;
+    void                loadKeyframeIndex();
+    void                buildKeyframeIndex();
+    bool                seekToKeyframe(int stream_index, std::int64_t timestamp);
 
 private:
 
     AVInputFormat*      _input_format;
 
+    bool                _start_point_pending;
+    std::deque<Packet>  _pending_packets;   ///< read by seekPrecise, not yet returned
+
+    bool                _keyframe_indexing;
+    bool                _persist_keyframe_index;
+    KeyframeIndex       _keyframe_index;
+
 };
 
 } // namespace fpp
@@ -0,0 +1,106 @@
+#include "KeyframeIndex.hpp"
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+namespace fpp {
+
+namespace {
+
+constexpr auto index_signature { "fppidx" };
+constexpr auto index_version   { 1 };
+
+} // namespace
+
+void KeyframeIndex::add(int stream_index, Entry entry) {
+    auto& entries { _entries[stream_index] };
+    /* demuxers deliver keyframes in decode order, keep them sorted by pts */
+    const auto it {
+        std::upper_bound(entries.begin(), entries.end(), entry.pts
+            , [](std::int64_t pts, const Entry& e) { return pts < e.pts; }
+        )
+    };
+    entries.insert(it, entry);
+}
+
+void KeyframeIndex::clear() {
+    _entries.clear();
+}
+
+bool KeyframeIndex::empty() const {
+    return _entries.empty();
+}
+
+std::size_t KeyframeIndex::size(int stream_index) const {
+    if (const auto it { _entries.find(stream_index) }; it != _entries.end()) {
+        return it->second.size();
+    }
+    return 0;
+}
+
+std::vector<KeyframeIndex::Entry> KeyframeIndex::entries(int stream_index) const {
+    if (const auto it { _entries.find(stream_index) }; it != _entries.end()) {
+        return it->second;
+    }
+    return {};
+}
+
+std::optional<KeyframeIndex::Entry> KeyframeIndex::findPreceding(int stream_index, std::int64_t timestamp) const {
+    const auto it { _entries.find(stream_index) };
+    if ((it == _entries.end()) || it->second.empty()) {
+        return std::nullopt;
+    }
+    const auto& entries { it->second };
+    const auto next {
+        std::upper_bound(entries.begin(), entries.end(), timestamp
+            , [](std::int64_t ts, const Entry& e) { return ts < e.pts; }
+        )
+    };
+    if (next == entries.begin()) {
+        return entries.front();
+    }
+    return *std::prev(next);
+}
+
+bool KeyframeIndex::load(const std::string_view path, std::int64_t source_size) {
+    std::ifstream file { std::string { path } };
+    if (!file) {
+        return false;
+    }
+    std::string  signature;
+    int          version      { 0 };
+    std::int64_t indexed_size { 0 };
+    file >> signature >> version >> indexed_size;
+    if ((signature != index_signature)
+            || (version != index_version)
+            || (indexed_size != source_size)) {
+        return false;
+    }
+    std::map<int,std::vector<Entry>> entries;
+    int   stream_index { 0 };
+    Entry entry {};
+    while (file >> stream_index >> entry.pts >> entry.pos) {
+        entries[stream_index].push_back(entry);
+    }
+    if (!file.eof()) {
+        return false;
+    }
+    _entries = std::move(entries);
+    return true;
+}
+
+bool KeyframeIndex::save(const std::string_view path, std::int64_t source_size) const {
+    std::ofstream file { std::string { path } };
+    if (!file) {
+        return false;
+    }
+    file << index_signature << ' ' << index_version << ' ' << source_size << '\n';
+    for (const auto& [stream_index, entries] : _entries) {
+        for (const auto& entry : entries) {
+            file << stream_index << ' ' << entry.pts << ' ' << entry.pos << '\n';
+        }
+    }
+    return bool(file);
+}
+
+} // namespace fpp
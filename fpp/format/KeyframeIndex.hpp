@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace fpp {
+
+/* Keyframe positions per stream, timestamps in stream time base */
+class KeyframeIndex {
+
+public:
+
+    struct Entry {
+        std::int64_t    pts;
+        std::int64_t    pos;    ///< byte offset, -1 if unknown
+    };
+
+    void                add(int stream_index, Entry entry);
+    void                clear();
+
+    bool                empty() const;
+    std::size_t         size(int stream_index) const;
+    std::vector<Entry>  entries(int stream_index) const;
+
+    /* last keyframe with pts <= timestamp */
+    std::optional<Entry> findPreceding(int stream_index, std::int64_t timestamp) const;
+
+    /* source_size guards against a stale index of a rewritten file */
+    bool                load(const std::string_view path, std::int64_t source_size);
+    bool                save(const std::string_view path, std::int64_t source_size) const;
+
+private:
+
+    std::map<int,std::vector<Entry>> _entries;
+
+};
+
+} // namespace fpp
@@ -1,6 +1,9 @@
 #include "OutputFormatContext.hpp"
 #include <fpp/core/Utils.hpp>
 #include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/time/LatencyTracer.hpp>
+#include <fpp/core/AllocationTracker.hpp>
+#include <fpp/filter/BitStreamFilterContext.hpp>
 
 extern "C" {
     #include <libavformat/avformat.h>
@@ -9,13 +12,15 @@ extern "C" {
 namespace fpp {
 
 OutputFormatContext::OutputFormatContext(const std::string_view mrl, const std::string_view format)
-    : _output_format { guessFormatByName(format) } {
+    : _output_format { guessFormatByName(format) }
+    , _auto_bitstream_filters { true } {
     setMediaResourceLocator(mrl);
     createContext();
 }
 
 OutputFormatContext::OutputFormatContext(OutputContext* output_ctx, const std::string_view format)
-    : _output_format { guessFormatByName(format) } {
+    : _output_format { guessFormatByName(format) }
+    , _auto_bitstream_filters { true } {
     setMediaResourceLocator("Custom output buffer");
     createContext();
     raw()->pb = output_ctx->raw();
@@ -33,21 +38,57 @@ OutputFormatContext::~OutputFormatContext() {
 }
 
 bool OutputFormatContext::write(Packet packet) {
+    FPP_ALLOCATION_SCOPE(Write);
+    const auto index { std::size_t(packet.streamIndex()) };
+    if (!packet.isEOF() && (index < _bitstream_filters.size()) && _bitstream_filters[index]) {
+        const auto time_base { packet.timeBase() };
+        for (auto& filtered : _bitstream_filters[index]->filter(std::move(packet))) {
+            filtered.setTimeBase(time_base);
+            filtered.setStreamIndex(int(index));
+            if (!writePacket(filtered)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return writePacket(packet);
+}
+
+bool OutputFormatContext::writePacket(Packet& packet) {
     if (!processPacket(packet)) {
         return false;
     }
     setInterruptTimeout(getTimeout(TimeoutProcess::Writing));
     ffmpeg_api_non_strict(av_write_frame, raw(), packet.ptr());
+    traceWrittenPacket(packet.trace());
     return true;
 }
 
 bool OutputFormatContext::interleavedWrite(Packet& packet) {
+    FPP_ALLOCATION_SCOPE(Write);
+    const auto index { std::size_t(packet.streamIndex()) };
+    if (!packet.isEOF() && (index < _bitstream_filters.size()) && _bitstream_filters[index]) {
+        const auto time_base { packet.timeBase() };
+        for (auto& filtered : _bitstream_filters[index]->filter(packet)) {
+            filtered.setTimeBase(time_base);
+            filtered.setStreamIndex(int(index));
+            if (!interleavedWritePacket(filtered)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return interleavedWritePacket(packet);
+}
+
+bool OutputFormatContext::interleavedWritePacket(Packet& packet) {
     processPacket(packet);
     if (packet.isEOF()) {
         return false;
     }
     setInterruptTimeout(getTimeout(TimeoutProcess::Writing));
     ffmpeg_api_non_strict(av_interleaved_write_frame, raw(), packet.ptr());
+    traceWrittenPacket(packet.trace());
     return true;
 }
 
@@ -138,6 +179,7 @@ std::string OutputFormatContext::formatName() const {
 }
 
 void OutputFormatContext::closeContext() {
+    flushBitstreamFilters();
     writeTrailer();
     if (!isFlagSet(AVFMT_NOFILE)) {
         ffmpeg_api_strict(avio_close, raw()->pb);
@@ -150,12 +192,84 @@ void OutputFormatContext::createStream(SpParameters params) {
     const auto avstream  { ::avformat_new_stream(raw(), params->codec()) };
     const auto fppstream { Stream::make_output_stream(avstream, params)  };
     addStream(fppstream);
+    _bitstream_filters.resize(streamNumber());
 }
 
 void OutputFormatContext::copyStream(const SharedStream other) {
     const auto output_params { utils::make_params(other->params->type()) };
     output_params->completeFrom(other->params);
+
+    if (::avformat_query_codec(outputFormat(), other->params->codecId(), FF_COMPLIANCE_NORMAL) == 0) {
+        log_warning() << formatName() << " does not support "
+                      << other->params->codecId() << ", the output may be broken";
+    }
+
+    std::shared_ptr<BitStreamFilterContext> bitstream_filter;
+    if (const auto filter_name {
+            _auto_bitstream_filters ? negotiateBitstreamFilter(other->params) : std::string {}
+        }; !filter_name.empty()) {
+        bitstream_filter = std::make_shared<BitStreamFilterContext>(other->params, filter_name);
+        /* extradata in the form the muxer expects */
+        output_params->parseCodecpar(bitstream_filter->raw()->par_out);
+        log_info() << "Stream #" << streamNumber() << ": inserted " << filter_name;
+    }
     createStream(output_params);
+    _bitstream_filters.back() = bitstream_filter;
+}
+
+void OutputFormatContext::setAutoBitstreamFilters(bool enabled) {
+    _auto_bitstream_filters = enabled;
+}
+
+std::shared_ptr<BitStreamFilterContext> OutputFormatContext::bitstreamFilter(std::size_t stream_index) const {
+    return stream_index < _bitstream_filters.size() ? _bitstream_filters[stream_index] : nullptr;
+}
+
+std::string OutputFormatContext::negotiateBitstreamFilter(const SpParameters in_params) const {
+    const auto out_flags { _output_format->flags };
+    const std::string_view out_name { _output_format->name };
+    /* muxers with global headers store length prefixed H.264/HEVC
+     * and raw AAC, the rest (mpegts, raw h264/hevc) want Annex-B
+     * and ADTS; rtp packetizers accept both layouts */
+    const auto global_header { (out_flags & AVFMT_GLOBALHEADER) != 0 };
+    const auto rtp { (out_name == "rtp") || (out_name == "rtsp") };
+    const auto [data, size] { in_params->extradata() };
+
+    switch (in_params->codecId()) {
+    case AV_CODEC_ID_H264:
+    case AV_CODEC_ID_HEVC: {
+        /* avcC/hvcC extradata starts with configuration version 1 */
+        const auto length_prefixed { data && (size > 0) && (data[0] == 1) };
+        if (length_prefixed && !global_header && !rtp) {
+            return in_params->codecId() == AV_CODEC_ID_H264
+                ? "h264_mp4toannexb"
+                : "hevc_mp4toannexb";
+        }
+        return {};
+    }
+    case AV_CODEC_ID_AAC: {
+        /* ADTS input (e.g. from mpegts) carries no AudioSpecificConfig */
+        const auto adts { !data || (size == 0) };
+        if (adts && global_header) {
+            return "aac_adtstoasc";
+        }
+        return {};
+    }
+    default:
+        return {};
+    }
+}
+
+void OutputFormatContext::flushBitstreamFilters() {
+    for (std::size_t index { 0 }; index < _bitstream_filters.size(); ++index) {
+        if (!_bitstream_filters[index]) {
+            continue;
+        }
+        for (auto& filtered : _bitstream_filters[index]->flush()) {
+            filtered.setStreamIndex(int(index));
+            interleavedWritePacket(filtered);
+        }
+    }
 }
 
 void OutputFormatContext::guessOutputFromat() {
@@ -202,6 +316,14 @@ void OutputFormatContext::parseStreamsTimeBase() {
     }
 }
 
+void OutputFormatContext::traceWrittenPacket(Trace trace) {
+    if (trace.empty()) {
+        return;
+    }
+    trace.mark(Trace::Hop::Write);
+    LatencyTracer::instance().record(trace);
+}
+
 AVOutputFormat* OutputFormatContext::outputFormat() {
     return _output_format;
 }
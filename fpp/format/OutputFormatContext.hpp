@@ -4,6 +4,8 @@
 
 namespace fpp {
 
+class BitStreamFilterContext;
+
 class OutputFormatContext : public FormatContext {
 
 public:
@@ -16,8 +18,14 @@ public:
     AVOutputFormat*     outputFormat();
 
     void                createStream(SpParameters params);
+    /* inserts the bitstream filter the sink's muxer needs (Annex-B
+     * for H.264/HEVC, raw AAC instead of ADTS) unless disabled */
     void                copyStream(const SharedStream other);
 
+    void                setAutoBitstreamFilters(bool enabled);
+    /* nullptr if packets of the stream are written as is */
+    std::shared_ptr<BitStreamFilterContext> bitstreamFilter(std::size_t stream_index) const;
+
     bool                write(Packet packet);
     bool                interleavedWrite(Packet& packet);
 
@@ -39,10 +47,20 @@ private:
     void                writeTrailer();
     void                initStreamsCodecpar();
     void                parseStreamsTimeBase();
+    void                traceWrittenPacket(Trace trace);
+
+    std::string         negotiateBitstreamFilter(const SpParameters in_params) const;
+    bool                writePacket(Packet& packet);
+    bool                interleavedWritePacket(Packet& packet);
+    void                flushBitstreamFilters();
 
 private:
 
+    using BitStreamFilterVector = std::vector<std::shared_ptr<BitStreamFilterContext>>;
+
     AVOutputFormat*     _output_format;
+    bool                _auto_bitstream_filters;
+    BitStreamFilterVector _bitstream_filters;
 
 };
 
@@ -0,0 +1,111 @@
+INCLUDEPATH += $$PWD/..
+
+SOURCES += \
+    $$PWD/base/CodecContext.cpp \
+    $$PWD/base/Dictionary.cpp \
+    $$PWD/base/FilterChain.cpp \
+    $$PWD/base/FilterContext.cpp \
+    $$PWD/base/FilterGraph.cpp \
+    $$PWD/base/FilterTemplateCache.cpp \
+    $$PWD/base/FormatContext.cpp \
+    $$PWD/base/Frame.cpp \
+    $$PWD/base/IOContext.cpp \
+    $$PWD/base/Packet.cpp \
+    $$PWD/base/Parameters.cpp \
+    $$PWD/codec/DecoderContext.cpp \
+    $$PWD/codec/EncoderContext.cpp \
+    $$PWD/core/AllocationTracker.cpp \
+    $$PWD/core/FFmpegException.cpp \
+    $$PWD/core/Logger.cpp \
+    $$PWD/core/Object.cpp \
+    $$PWD/core/ThreadPool.cpp \
+    $$PWD/core/Utils.cpp \
+    $$PWD/core/time/LatencyHistogram.cpp \
+    $$PWD/core/time/LatencyTracer.cpp \
+    $$PWD/core/time/Rescaler.cpp \
+    $$PWD/filter/BitStreamFilterContext.cpp \
+    $$PWD/filter/ComplexFilterGraph.cpp \
+    $$PWD/filter/FrameSynchronizer.cpp \
+    $$PWD/filter/LinearFilterGraph.cpp \
+    $$PWD/format/InputContext.cpp \
+    $$PWD/format/InputFormatContext.cpp \
+    $$PWD/format/KeyframeIndex.cpp \
+    $$PWD/format/OutputContext.cpp \
+    $$PWD/format/OutputFormatContext.cpp \
+    $$PWD/pipeline/AudioMixer.cpp \
+    $$PWD/pipeline/Compositor.cpp \
+    $$PWD/pipeline/Concatenator.cpp \
+    $$PWD/pipeline/KeyframePassthrough.cpp \
+    $$PWD/pipeline/Remuxer.cpp \
+    $$PWD/pipeline/SegmentJoiner.cpp \
+    $$PWD/pipeline/SegmentTranscoder.cpp \
+    $$PWD/pipeline/SharedEncoderOutput.cpp \
+    $$PWD/pipeline/ThumbnailExtractor.cpp \
+    $$PWD/pipeline/Trimmer.cpp \
+    $$PWD/refi/VideoFilters/Drawtext.cpp \
+    $$PWD/resample/AudioFifo.cpp \
+    $$PWD/resample/ResampleContext.cpp \
+    $$PWD/scale/RescaleContext.cpp \
+    $$PWD/stream/AudioParameters.cpp \
+    $$PWD/stream/Stream.cpp \
+    $$PWD/stream/VideoParameters.cpp
+
+HEADERS += \
+    $$PWD/base/CodecContext.hpp \
+    $$PWD/base/Dictionary.hpp \
+    $$PWD/base/FilterChain.hpp \
+    $$PWD/base/FilterContext.hpp \
+    $$PWD/base/FilterGraph.hpp \
+    $$PWD/base/FilterTemplateCache.hpp \
+    $$PWD/base/FormatContext.hpp \
+    $$PWD/base/Frame.hpp \
+    $$PWD/base/IOContext.hpp \
+    $$PWD/base/MediaData.hpp \
+    $$PWD/base/Packet.hpp \
+    $$PWD/base/Parameters.hpp \
+    $$PWD/codec/DecoderContext.hpp \
+    $$PWD/codec/EncoderContext.hpp \
+    $$PWD/core/AllocationTracker.hpp \
+    $$PWD/core/FFmpegException.hpp \
+    $$PWD/core/Logger.hpp \
+    $$PWD/core/Object.hpp \
+    $$PWD/core/ThreadPool.hpp \
+    $$PWD/core/Utils.hpp \
+    $$PWD/core/time/Chronometer.hpp \
+    $$PWD/core/time/LatencyHistogram.hpp \
+    $$PWD/core/time/LatencyTracer.hpp \
+    $$PWD/core/time/Rescaler.hpp \
+    $$PWD/core/time/Trace.hpp \
+    $$PWD/core/wrap/FFmpegObject.hpp \
+    $$PWD/core/wrap/SharedFFmpegObject.hpp \
+    $$PWD/filter/BitStreamFilterContext.hpp \
+    $$PWD/filter/ComplexFilterGraph.hpp \
+    $$PWD/filter/FrameSynchronizer.hpp \
+    $$PWD/filter/LinearFilterGraph.hpp \
+    $$PWD/format/InputContext.hpp \
+    $$PWD/format/InputFormatContext.hpp \
+    $$PWD/format/KeyframeIndex.hpp \
+    $$PWD/format/OutputContext.hpp \
+    $$PWD/format/OutputFormatContext.hpp \
+    $$PWD/pipeline/AudioMixer.hpp \
+    $$PWD/pipeline/Compositor.hpp \
+    $$PWD/pipeline/Concatenator.hpp \
+    $$PWD/pipeline/KeyframePassthrough.hpp \
+    $$PWD/pipeline/Remuxer.hpp \
+    $$PWD/pipeline/SegmentJoiner.hpp \
+    $$PWD/pipeline/SegmentTranscoder.hpp \
+    $$PWD/pipeline/SharedEncoderOutput.hpp \
+    $$PWD/pipeline/ThumbnailExtractor.hpp \
+    $$PWD/pipeline/Trimmer.hpp \
+    $$PWD/refi/VideoFilters/DrawText.hpp \
+    $$PWD/resample/AudioFifo.hpp \
+    $$PWD/resample/ResampleContext.hpp \
+    $$PWD/scale/RescaleContext.hpp \
+    $$PWD/stream/AudioParameters.hpp \
+    $$PWD/stream/Stream.hpp \
+    $$PWD/stream/VideoParameters.hpp
+
+# Allocation tracking build: qmake CONFIG+=fpp_alloc_tracking
+fpp_alloc_tracking {
+    DEFINES += FPP_TRACK_ALLOCATIONS
+}
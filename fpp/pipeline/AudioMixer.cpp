@@ -0,0 +1,371 @@
+#include "AudioMixer.hpp"
+#include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/Utils.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#   if defined(__GNUC__) || defined(__clang__)
+#       define FPP_MIX_AVX2
+#       define FPP_TARGET_AVX2 __attribute__((target("avx2")))
+#   elif defined(__AVX2__)
+#       define FPP_MIX_AVX2
+#       define FPP_TARGET_AVX2
+#   endif
+#   if defined(FPP_MIX_AVX2)
+#       include <immintrin.h>
+#   endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#   define FPP_MIX_NEON
+#   include <arm_neon.h>
+#endif
+
+extern "C" {
+    #include <libavutil/frame.h>
+}
+
+namespace fpp {
+
+namespace {
+
+constexpr float s16_scale     { 32768.f };
+constexpr float s16_scale_inv { 1.f / 32768.f };
+
+struct MixKernels {
+    /* dst += src * gain */
+    void (*mix)(float* dst, const float* src, float gain, std::size_t n);
+    /* dst = clamp(src, -1, 1) */
+    void (*clip)(float* dst, const float* src, std::size_t n);
+    void (*to_s16)(std::int16_t* dst, const float* src, std::size_t n);
+    void (*from_s16)(float* dst, const std::int16_t* src, std::size_t n);
+    const char* name;
+};
+
+void mix_scalar(float* dst, const float* src, float gain, std::size_t n) {
+    for (std::size_t i { 0 }; i < n; ++i) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+void clip_scalar(float* dst, const float* src, std::size_t n) {
+    for (std::size_t i { 0 }; i < n; ++i) {
+        dst[i] = std::clamp(src[i], -1.f, 1.f);
+    }
+}
+
+void to_s16_scalar(std::int16_t* dst, const float* src, std::size_t n) {
+    for (std::size_t i { 0 }; i < n; ++i) {
+        const auto value { std::lrint(src[i] * s16_scale) };
+        dst[i] = std::int16_t(std::clamp(value, -32768l, 32767l));
+    }
+}
+
+void from_s16_scalar(float* dst, const std::int16_t* src, std::size_t n) {
+    for (std::size_t i { 0 }; i < n; ++i) {
+        dst[i] = float(src[i]) * s16_scale_inv;
+    }
+}
+
+#if defined(FPP_MIX_AVX2)
+
+FPP_TARGET_AVX2 void mix_avx2(float* dst, const float* src, float gain, std::size_t n) {
+    const auto g { _mm256_set1_ps(gain) };
+    std::size_t i { 0 };
+    for (; i + 8 <= n; i += 8) {
+        const auto d { _mm256_loadu_ps(dst + i) };
+        const auto s { _mm256_loadu_ps(src + i) };
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(d, _mm256_mul_ps(s, g)));
+    }
+    mix_scalar(dst + i, src + i, gain, n - i);
+}
+
+FPP_TARGET_AVX2 void clip_avx2(float* dst, const float* src, std::size_t n) {
+    const auto lo { _mm256_set1_ps(-1.f) };
+    const auto hi { _mm256_set1_ps(1.f) };
+    std::size_t i { 0 };
+    for (; i + 8 <= n; i += 8) {
+        const auto s { _mm256_loadu_ps(src + i) };
+        _mm256_storeu_ps(dst + i, _mm256_min_ps(_mm256_max_ps(s, lo), hi));
+    }
+    clip_scalar(dst + i, src + i, n - i);
+}
+
+FPP_TARGET_AVX2 void to_s16_avx2(std::int16_t* dst, const float* src, std::size_t n) {
+    const auto scale { _mm256_set1_ps(s16_scale) };
+    std::size_t i { 0 };
+    for (; i + 8 <= n; i += 8) {
+        /* cvtps rounds to nearest, packs saturates to int16 */
+        const auto s { _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale)) };
+        const auto packed {
+            _mm_packs_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1))
+        };
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+    }
+    to_s16_scalar(dst + i, src + i, n - i);
+}
+
+FPP_TARGET_AVX2 void from_s16_avx2(float* dst, const std::int16_t* src, std::size_t n) {
+    const auto scale { _mm256_set1_ps(s16_scale_inv) };
+    std::size_t i { 0 };
+    for (; i + 8 <= n; i += 8) {
+        const auto s {
+            _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)))
+        };
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+    }
+    from_s16_scalar(dst + i, src + i, n - i);
+}
+
+bool avx2_supported() {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#else
+    return true; /* built with /arch:AVX2 */
+#endif
+}
+
+#endif // FPP_MIX_AVX2
+
+#if defined(FPP_MIX_NEON)
+
+void mix_neon(float* dst, const float* src, float gain, std::size_t n) {
+    std::size_t i { 0 };
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+    }
+    mix_scalar(dst + i, src + i, gain, n - i);
+}
+
+void clip_neon(float* dst, const float* src, std::size_t n) {
+    const auto lo { vdupq_n_f32(-1.f) };
+    const auto hi { vdupq_n_f32(1.f) };
+    std::size_t i { 0 };
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vminq_f32(vmaxq_f32(vld1q_f32(src + i), lo), hi));
+    }
+    clip_scalar(dst + i, src + i, n - i);
+}
+
+void to_s16_neon(std::int16_t* dst, const float* src, std::size_t n) {
+    std::size_t i { 0 };
+    for (; i + 4 <= n; i += 4) {
+        /* vcvtn rounds to nearest, vqmovn saturates to int16 */
+        const auto s { vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + i), s16_scale)) };
+        vst1_s16(dst + i, vqmovn_s32(s));
+    }
+    to_s16_scalar(dst + i, src + i, n - i);
+}
+
+void from_s16_neon(float* dst, const std::int16_t* src, std::size_t n) {
+    std::size_t i { 0 };
+    for (; i + 4 <= n; i += 4) {
+        const auto s { vmovl_s16(vld1_s16(src + i)) };
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(s), s16_scale_inv));
+    }
+    from_s16_scalar(dst + i, src + i, n - i);
+}
+
+#endif // FPP_MIX_NEON
+
+const MixKernels& kernels() {
+    static const MixKernels selected {
+        []() -> MixKernels {
+#if defined(FPP_MIX_AVX2)
+            if (avx2_supported()) {
+                return { mix_avx2, clip_avx2, to_s16_avx2, from_s16_avx2, "avx2" };
+            }
+#elif defined(FPP_MIX_NEON)
+            return { mix_neon, clip_neon, to_s16_neon, from_s16_neon, "neon" };
+#endif
+            return { mix_scalar, clip_scalar, to_s16_scalar, from_s16_scalar, "scalar" };
+        }()
+    };
+    return selected;
+}
+
+bool supported_format(int format) {
+    return (format == AV_SAMPLE_FMT_FLTP) || (format == AV_SAMPLE_FMT_S16P);
+}
+
+} // namespace
+
+AudioMixer::AudioMixer(const SpParameters output)
+    : _params { std::static_pointer_cast<const AudioParameters>(output) }
+    , _samples_count { 0 } {
+    if (!_params->isAudio()) {
+        throw FFmpegException { "Audio mixer requires audio parameters" };
+    }
+    if (!supported_format(_params->sampleFormat())) {
+        throw FFmpegException {
+            "Audio mixer supports fltp and s16p only, got "
+                + utils::to_string(_params->sampleFormat())
+        };
+    }
+    if (_params->frameSize() <= 0) {
+        throw FFmpegException { "Audio mixer requires output frame size" };
+    }
+    _accumulator.resize(
+        std::size_t(_params->channels())
+        , std::vector<float>(std::size_t(_params->frameSize()))
+    );
+    log_info() << "Inited: " << _params->sampleFormat()
+               << ", channels " << _params->channels()
+               << ", nb_smp " << _params->frameSize()
+               << ", kernel " << kernel();
+}
+
+std::size_t AudioMixer::addInput(float gain, std::int64_t delay) {
+    Input input;
+    input.gain = gain;
+    input.finished = false;
+    input.read_pos = 0;
+    /* delay line starts with the requested amount of silence */
+    const auto delay_samples {
+        std::size_t(::av_rescale(std::max(delay, std::int64_t { 0 }), _params->sampleRate(), 1000))
+    };
+    input.line.resize(std::size_t(_params->channels()), std::vector<float>(delay_samples, 0.f));
+    _inputs.push_back(std::move(input));
+    return _inputs.size() - 1;
+}
+
+void AudioMixer::setGain(std::size_t input, float gain) {
+    _inputs.at(input).gain = gain;
+}
+
+void AudioMixer::push(std::size_t input, const Frame& frame) {
+    auto& in { _inputs.at(input) };
+    if (in.finished) {
+        log_warning() << "Input #" << input << " is finished, frame ignored";
+        return;
+    }
+    const auto& raw { *frame.ptr() };
+    if (!supported_format(raw.format)
+            || (raw.sample_rate != _params->sampleRate())
+            || (raw.channels != int(_params->channels()))) {
+        throw FFmpegException {
+            "Mixer input #" + std::to_string(input)
+                + " does not match the output parameters, resample it first"
+        };
+    }
+
+    const auto nb_samples { std::size_t(raw.nb_samples) };
+    const auto& k { kernels() };
+    for (std::size_t ch { 0 }; ch < in.line.size(); ++ch) {
+        auto& line { in.line[ch] };
+        const auto offset { line.size() };
+        line.resize(offset + nb_samples);
+        if (raw.format == AV_SAMPLE_FMT_FLTP) {
+            std::copy_n(reinterpret_cast<const float*>(raw.extended_data[ch]), nb_samples, line.data() + offset);
+        }
+        else {
+            k.from_s16(line.data() + offset, reinterpret_cast<const std::int16_t*>(raw.extended_data[ch]), nb_samples);
+        }
+    }
+}
+
+void AudioMixer::finish(std::size_t input) {
+    _inputs.at(input).finished = true;
+}
+
+FrameVector AudioMixer::mix() {
+    return mixFrames();
+}
+
+FrameVector AudioMixer::flush() {
+    for (auto& input : _inputs) {
+        input.finished = true;
+    }
+    return mixFrames();
+}
+
+std::string AudioMixer::kernel() const {
+    return kernels().name;
+}
+
+FrameVector AudioMixer::mixFrames() {
+    const auto frame_size { std::size_t(_params->frameSize()) };
+    FrameVector frames;
+    while (true) {
+        /* active inputs hold the mix back until they have
+         * a full frame, finished ones are padded with silence */
+        auto ready { !_inputs.empty() };
+        std::size_t longest { 0 };
+        for (const auto& input : _inputs) {
+            longest = std::max(longest, std::min(input.available(), frame_size));
+            if (!input.finished && (input.available() < frame_size)) {
+                ready = false;
+            }
+        }
+        if (!ready || (longest == 0)) {
+            break;
+        }
+        /* shorter than the frame size only when every input is finished */
+        const auto nb_samples { longest };
+
+        Frame frame { createFrame(int(nb_samples)) };
+        mixInto(frame, int(nb_samples));
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+Frame AudioMixer::createFrame(int nb_samples) const {
+    Frame frame { Media::Type::Audio };
+    frame.raw().nb_samples     = nb_samples;
+    frame.raw().channel_layout = _params->channelLayout();
+    frame.raw().channels       = int(_params->channels());
+    frame.raw().format         = _params->sampleFormat();
+    frame.raw().sample_rate    = _params->sampleRate();
+    constexpr auto align { 32 };
+    ffmpeg_api_strict(av_frame_get_buffer, frame.ptr(), align);
+    return frame;
+}
+
+void AudioMixer::mixInto(Frame& frame, int nb_samples) {
+    const auto& k { kernels() };
+    const auto n { std::size_t(nb_samples) };
+    for (std::size_t ch { 0 }; ch < _accumulator.size(); ++ch) {
+        auto& acc { _accumulator[ch] };
+        std::fill_n(acc.begin(), n, 0.f);
+        for (const auto& input : _inputs) {
+            const auto count { std::min(input.available(), n) };
+            k.mix(acc.data(), input.line[ch].data() + input.read_pos, input.gain, count);
+        }
+        if (_params->sampleFormat() == AV_SAMPLE_FMT_FLTP) {
+            k.clip(reinterpret_cast<float*>(frame.raw().extended_data[ch]), acc.data(), n);
+        }
+        else {
+            k.to_s16(reinterpret_cast<std::int16_t*>(frame.raw().extended_data[ch]), acc.data(), n);
+        }
+    }
+    for (auto& input : _inputs) {
+        input.consume(std::min(input.available(), n));
+    }
+
+    const auto time_base {
+        not_inited_q(_params->timeBase())
+            ? ::av_make_q(1, int(_params->sampleRate()))
+            : _params->timeBase()
+    };
+    frame.setPts(::av_rescale_q(_samples_count, ::av_make_q(1, int(_params->sampleRate())), time_base));
+    frame.setTimeBase(time_base);
+    frame.setStreamIndex(0);
+    _samples_count += nb_samples;
+}
+
+std::size_t AudioMixer::Input::available() const {
+    return line.empty() ? 0 : line.front().size() - read_pos;
+}
+
+void AudioMixer::Input::consume(std::size_t nb_samples) {
+    read_pos += nb_samples;
+    /* compact once the consumed part dominates the line */
+    if (!line.empty() && (read_pos * 2 >= line.front().size())) {
+        for (auto& samples : line) {
+            samples.erase(samples.begin(), samples.begin() + std::ptrdiff_t(read_pos));
+        }
+        read_pos = 0;
+    }
+}
+
+} // namespace fpp
@@ -0,0 +1,61 @@
+#pragma once
+#include <fpp/core/Object.hpp>
+#include <fpp/stream/AudioParameters.hpp>
+#include <fpp/base/Frame.hpp>
+#include <vector>
+
+namespace fpp {
+
+/* Mixes any number of audio inputs with per-input gain and delay,
+ * without a filter graph. Inputs must already match the output
+ * sample rate and channel count, planar float or planar s16.
+ * Output frames have the output frame size and are stamped
+ * by sample count in the output parameters time base */
+class AudioMixer : public Object {
+
+public:
+
+    explicit AudioMixer(const SpParameters output);
+
+    /* delay in ms, returns the input index */
+    std::size_t         addInput(float gain = 1.f, std::int64_t delay = 0);
+    void                setGain(std::size_t input, float gain);
+
+    void                push(std::size_t input, const Frame& frame);
+    /* input will not receive more frames, pad it with silence */
+    void                finish(std::size_t input);
+
+    /* frames ready once every active input has a full frame buffered */
+    FrameVector         mix();
+    /* mixes everything left, the last frame may be shorter */
+    FrameVector         flush();
+
+    /* name of the selected kernel set: avx2, neon or scalar */
+    std::string         kernel() const;
+
+private:
+
+    struct Input {
+        float           gain;
+        bool            finished;
+        std::size_t     read_pos;
+        std::vector<std::vector<float>> line;   ///< delay line per channel
+
+        std::size_t     available() const;
+        void            consume(std::size_t nb_samples);
+    };
+
+    FrameVector         mixFrames();
+    Frame               createFrame(int nb_samples) const;
+    void                mixInto(Frame& frame, int nb_samples);
+
+private:
+
+    const std::shared_ptr<const AudioParameters> _params;
+    std::vector<Input>  _inputs;
+    std::vector<std::vector<float>> _accumulator;
+    std::int64_t        _samples_count;
+
+};
+
+} // namespace fpp
@@ -0,0 +1,165 @@
+#include "Compositor.hpp"
+#include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/ThreadPool.hpp>
+#include <fpp/core/Utils.hpp>
+#include <cstring>
+
+extern "C" {
+    #include <libavutil/pixdesc.h>
+    #include <libavutil/mathematics.h>
+}
+
+namespace fpp {
+
+Compositor::Compositor(const SpParameters output, std::size_t columns, std::size_t rows)
+    : _params { std::static_pointer_cast<const VideoParameters>(output) }
+    , _columns { columns }
+    , _rows { rows }
+    , _tile_width { 0 }
+    , _tile_height { 0 } {
+    if (!_params->isVideo() || (columns == 0) || (rows == 0)) {
+        throw FFmpegException { "Compositor requires video parameters and a non empty grid" };
+    }
+    const auto desc { ::av_pix_fmt_desc_get(_params->pixelFormat()) };
+    if (!desc || (desc->flags & AV_PIX_FMT_FLAG_PAL)) {
+        throw FFmpegException {
+            "Compositor does not support " + utils::to_string(_params->pixelFormat())
+        };
+    }
+    /* tile origins must fall on chroma sample boundaries */
+    const auto align_w { 1 << desc->log2_chroma_w };
+    const auto align_h { 1 << desc->log2_chroma_h };
+    _tile_width  = (_params->width()  / int(columns)) / align_w * align_w;
+    _tile_height = (_params->height() / int(rows))    / align_h * align_h;
+    if ((_tile_width == 0) || (_tile_height == 0)) {
+        throw FFmpegException { "Compositor canvas is too small for the grid" };
+    }
+
+    _tiles.reserve(columns * rows);
+    for (std::size_t i { 0 }; i < columns * rows; ++i) {
+        auto tile { std::make_unique<Tile>() };
+        tile->x = int(i % columns) * _tile_width;
+        tile->y = int(i / columns) * _tile_height;
+        _tiles.push_back(std::move(tile));
+    }
+    log_info() << "Inited " << columns << 'x' << rows
+               << " mosaic, tile " << _tile_width << 'x' << _tile_height;
+}
+
+std::size_t Compositor::tileCount() const {
+    return _tiles.size();
+}
+
+void Compositor::push(std::size_t tile, const Frame& frame) {
+    auto& t { *_tiles.at(tile) };
+    std::lock_guard lock { t.mutex };
+    if (t.fresh) {
+        t.dropped++;
+    }
+    t.latest = frame;
+    t.fresh = true;
+}
+
+Frame Compositor::compose(std::int64_t frame_number) {
+    /* snapshot under the tile locks, scale outside of them */
+    std::vector<Frame> frames(_tiles.size());
+    for (std::size_t i { 0 }; i < _tiles.size(); ++i) {
+        std::lock_guard lock { _tiles[i]->mutex };
+        if (_tiles[i]->latest.raw().buf[0]) {
+            frames[i] = _tiles[i]->latest;
+        }
+        _tiles[i]->fresh = false;
+    }
+
+    auto& canvas { acquireCanvas() };
+    ThreadPool::shared().parallelFor(int(_tiles.size()), [&](int i) {
+        const auto& frame { frames[std::size_t(i)] };
+        if (!frame.raw().buf[0]) {
+            return; /* no picture yet, tile stays blank */
+        }
+        auto& tile { *_tiles[std::size_t(i)] };
+        rescaler(tile, frame).scaleInto(frame, canvas, tile.x, tile.y);
+    });
+
+    /* the sink may replace the time base when it is opened */
+    canvas.setPts(::av_rescale_q(frame_number, ::av_inv_q(_params->frameRate()), _params->timeBase()));
+    canvas.setTimeBase(_params->timeBase());
+    canvas.setStreamIndex(0);
+    return canvas;
+}
+
+std::int64_t Compositor::dropped(std::size_t tile) const {
+    const auto& t { *_tiles.at(tile) };
+    std::lock_guard lock { t.mutex };
+    return t.dropped;
+}
+
+std::size_t Compositor::canvasCount() const {
+    return _canvases.size();
+}
+
+Frame& Compositor::acquireCanvas() {
+    /* writable means the encoder has released every reference */
+    for (auto& canvas : _canvases) {
+        if (::av_frame_is_writable(canvas.ptr())) {
+            return canvas;
+        }
+    }
+    _canvases.push_back(createCanvas());
+    return _canvases.back();
+}
+
+Frame Compositor::createCanvas() const {
+    Frame canvas { Media::Type::Video };
+    canvas.raw().format = _params->pixelFormat();
+    canvas.raw().width  = _params->width();
+    canvas.raw().height = _params->height();
+    constexpr auto align { 32 };
+    ffmpeg_api_strict(av_frame_get_buffer, canvas.ptr(), align);
+    clear(canvas);
+    return canvas;
+}
+
+void Compositor::clear(Frame& canvas) const {
+    const auto pix_fmt { _params->pixelFormat() };
+    const auto desc { ::av_pix_fmt_desc_get(pix_fmt) };
+    const auto rgb { (desc->flags & AV_PIX_FMT_FLAG_RGB) != 0 };
+    const auto alpha { (desc->flags & AV_PIX_FMT_FLAG_ALPHA) != 0 };
+    const auto nb_planes { ::av_pix_fmt_count_planes(pix_fmt) };
+    for (auto plane { 0 }; plane < nb_planes; ++plane) {
+        /* black: limited range luma and neutral chroma for yuv */
+        const auto chroma { !rgb && ((plane == 1) || (plane == 2)) };
+        const auto alpha_plane { alpha && (plane == nb_planes - 1) && (nb_planes > 1) };
+        const auto value { alpha_plane ? 0xFF : chroma ? 0x80 : (rgb ? 0x00 : 0x10) };
+        const auto height {
+            chroma ? AV_CEIL_RSHIFT(canvas.raw().height, desc->log2_chroma_h) : canvas.raw().height
+        };
+        std::memset(canvas.raw().data[plane], value, std::size_t(canvas.raw().linesize[plane]) * std::size_t(height));
+    }
+}
+
+RescaleContext& Compositor::rescaler(Tile& tile, const Frame& frame) {
+    const auto& raw { frame.raw() };
+    if (tile.rescaler) {
+        const auto in {
+            std::static_pointer_cast<const VideoParameters>(tile.rescaler->params.in)
+        };
+        if ((in->width() == raw.width) && (in->height() == raw.height)
+                && (in->pixelFormat() == raw.format)) {
+            return *tile.rescaler;
+        }
+    }
+    /* first frame of the feed or its resolution changed */
+    const auto in { VideoParameters::make_shared() };
+    in->setWidth(raw.width);
+    in->setHeight(raw.height);
+    in->setPixelFormat(AVPixelFormat(raw.format));
+    const auto out { VideoParameters::make_shared() };
+    out->setWidth(_tile_width);
+    out->setHeight(_tile_height);
+    out->setPixelFormat(_params->pixelFormat());
+    tile.rescaler = std::make_unique<RescaleContext>(InOutParams { in, out });
+    return *tile.rescaler;
+}
+
+} // namespace fpp
@@ -0,0 +1,63 @@
+#pragma once
+#include <fpp/scale/RescaleContext.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fpp {
+
+/* Composes a columns x rows mosaic of video feeds into canvases
+ * of the output parameters. Every tile keeps only the latest pushed
+ * frame, so a stalled feed shows its last picture instead of
+ * blocking the mosaic. Tiles are scaled in parallel on the shared
+ * thread pool straight into a canvas taken from a small pool */
+class Compositor : public Object {
+
+public:
+
+    Compositor(const SpParameters output, std::size_t columns, std::size_t rows);
+
+    std::size_t         tileCount() const;
+
+    /* thread safe, may be called from the feed's decoding thread */
+    void                push(std::size_t tile, const Frame& frame);
+
+    /* canvas with the latest frame of every tile, frame_number
+     * counts output frames and is stamped at the output frame rate
+     * in the output parameters time base */
+    Frame               compose(std::int64_t frame_number);
+
+    /* frames replaced by a newer one before being composed */
+    std::int64_t        dropped(std::size_t tile) const;
+    std::size_t         canvasCount() const;
+
+private:
+
+    struct Tile {
+        mutable std::mutex mutex;
+        Frame           latest;
+        bool            fresh       { false };
+        std::int64_t    dropped     { 0 };
+        int             x           { 0 };
+        int             y           { 0 };
+        std::unique_ptr<RescaleContext> rescaler;
+    };
+
+    Frame&              acquireCanvas();
+    Frame               createCanvas() const;
+    void                clear(Frame& canvas) const;
+    RescaleContext&     rescaler(Tile& tile, const Frame& frame);
+
+private:
+
+    const std::shared_ptr<const VideoParameters> _params;
+    const std::size_t   _columns;
+    const std::size_t   _rows;
+    int                 _tile_width;
+    int                 _tile_height;
+    std::vector<std::unique_ptr<Tile>> _tiles;
+    std::vector<Frame>  _canvases;
+
+};
+
+} // namespace fpp
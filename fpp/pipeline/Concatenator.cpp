@@ -0,0 +1,136 @@
+#include "Concatenator.hpp"
+#include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/Utils.hpp>
+#include <algorithm>
+#include <future>
+
+extern "C" {
+    #include <libavformat/avformat.h>
+}
+
+namespace fpp {
+
+Concatenator::Concatenator(std::vector<std::string> input_mrls, OutputFormatContext& sink)
+    : _input_mrls { std::move(input_mrls) }
+    , _sink { sink } {
+}
+
+void Concatenator::concatenate() {
+    if (_input_mrls.empty()) {
+        throw FFmpegException { "Nothing to concatenate" };
+    }
+
+    auto input { openInput(0) };
+    _reference_streams = input->streams();
+    for (const auto& stream : _reference_streams) {
+        _sink.copyStream(stream);
+    }
+    if (!_sink.open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(_sink.mediaResourceLocator()) };
+    }
+
+    for (std::size_t i { 0 }; i < _input_mrls.size(); ++i) {
+        std::future<UniqueInput> next_input;
+        if (i + 1 < _input_mrls.size()) {
+            next_input = std::async(std::launch::async
+                , [this,i]() { return openInput(i + 1); }
+            );
+        }
+        checkCompatibility(*input);
+        rebaseStamps(*input);
+        drain(*input);
+        input.reset();
+        if (next_input.valid()) {
+            input = next_input.get();
+        }
+    }
+
+    _sink.close();
+}
+
+Concatenator::UniqueInput Concatenator::openInput(std::size_t index) const {
+    auto input { std::make_unique<InputFormatContext>(_input_mrls[index]) };
+    if (!input->open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(_input_mrls[index]) };
+    }
+    return input;
+}
+
+void Concatenator::checkCompatibility(InputFormatContext& input) const {
+    const auto streams { input.streams() };
+    const auto incompatible {
+        [&](const std::string& reason) {
+            return FFmpegException {
+                "Cannot concatenate " + utils::quoted(input.mediaResourceLocator()) + ": " + reason
+            };
+        }
+    };
+    if (streams.size() != _reference_streams.size()) {
+        throw incompatible("stream count mismatch");
+    }
+    for (std::size_t i { 0 }; i < streams.size(); ++i) {
+        const auto& reference { _reference_streams[i]->params };
+        const auto& params    { streams[i]->params };
+        if (params->type() != reference->type()) {
+            throw incompatible("stream #" + std::to_string(i) + " type mismatch");
+        }
+        const InOutParams in_out { params, reference };
+        if (utils::transcoding_required(in_out)) {
+            throw incompatible("stream #" + std::to_string(i) + " codec mismatch");
+        }
+        /* betterThen both ways false - same picture size or sound quality */
+        const auto same_quality {
+            !params->betterThen(reference) && !reference->betterThen(params)
+        };
+        if (params->isVideo() && (!same_quality || utils::rescaling_required(in_out))) {
+            throw incompatible("stream #" + std::to_string(i) + " video parameters mismatch");
+        }
+        if (params->isAudio() && (!same_quality || utils::resampling_required(in_out))) {
+            throw incompatible("stream #" + std::to_string(i) + " audio parameters mismatch");
+        }
+        /* copied packets must be decodable with the sink's headers */
+        const auto [data, size] { params->extradata() };
+        const auto [reference_data, reference_size] { reference->extradata() };
+        if ((size != reference_size)
+                || ((size != 0) && !std::equal(data, data + size, reference_data))) {
+            throw incompatible("stream #" + std::to_string(i) + " extradata mismatch");
+        }
+    }
+}
+
+void Concatenator::rebaseStamps(InputFormatContext& input) {
+    /* the longest sink stream marks the boundary, so streams stay in sync */
+    auto boundary { std::int64_t { 0 } };
+    for (const auto& stream : _sink.streams()) {
+        if (stream->endStamp() != AV_NOPTS_VALUE) {
+            boundary = std::max(boundary
+                , ::av_rescale_q(stream->endStamp(), stream->params->timeBase(), AV_TIME_BASE_Q)
+            );
+        }
+    }
+    const auto input_start {
+        input.raw()->start_time != AV_NOPTS_VALUE ? input.raw()->start_time : 0
+    };
+    for (const auto& stream : _sink.streams()) {
+        stream->setStampOffset(
+            ::av_rescale_q(boundary - input_start, AV_TIME_BASE_Q, stream->params->timeBase())
+        );
+    }
+}
+
+void Concatenator::drain(InputFormatContext& input) {
+    while (true) {
+        auto packet { input.read() };
+        if (packet.isEOF()) {
+            break;
+        }
+        if (!_sink.interleavedWrite(packet)) {
+            throw FFmpegException {
+                "Failed to write packet of " + utils::quoted(input.mediaResourceLocator())
+                + " to " + utils::quoted(_sink.mediaResourceLocator())
+            };
+        }
+    }
+}
+
+} // namespace fpp
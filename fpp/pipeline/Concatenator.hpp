@@ -0,0 +1,38 @@
+#pragma once
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/format/OutputFormatContext.hpp>
+#include <memory>
+
+namespace fpp {
+
+/* Stream-copies inputs with compatible streams one after another into
+ * a single sink. Timestamps of every next input are rebased onto the end
+ * of the previous one by the sink's streams; the next input is opened in
+ * the background while the current one drains */
+class Concatenator {
+
+public:
+
+    Concatenator(std::vector<std::string> input_mrls, OutputFormatContext& sink);
+
+    /* opens the sink with streams of the first input */
+    void                concatenate();
+
+private:
+
+    using UniqueInput = std::unique_ptr<InputFormatContext>;
+
+    UniqueInput         openInput(std::size_t index) const;
+    void                checkCompatibility(InputFormatContext& input) const;
+    void                rebaseStamps(InputFormatContext& input);
+    void                drain(InputFormatContext& input);
+
+private:
+
+    const std::vector<std::string> _input_mrls;
+    OutputFormatContext& _sink;
+    StreamVector        _reference_streams;
+
+};
+
+} // namespace fpp
@@ -0,0 +1,78 @@
+#include "KeyframePassthrough.hpp"
+#include <fpp/stream/VideoParameters.hpp>
+#include <fpp/core/FFmpegException.hpp>
+
+extern "C" {
+    #include <libavformat/avformat.h>
+}
+
+namespace fpp {
+
+KeyframePassthrough::KeyframePassthrough(const SharedStream source_stream, OutputFormatContext& sink, AVRational preview_rate)
+    : _source_index { source_stream->index() }
+    , _sink { sink }
+    , _preview_time_base { ::av_inv_q(preview_rate) }
+    , _sink_index { -1 }
+    , _origin { AV_NOPTS_VALUE }
+    , _last_slot { AV_NOPTS_VALUE }
+    , _forwarded { 0 }
+    , _dropped { 0 } {
+    if (!source_stream->isVideo()) {
+        throw FFmpegException { "Keyframe passthrough requires a video stream" };
+    }
+    if ((preview_rate.num <= 0) || (preview_rate.den <= 0)) {
+        throw FFmpegException { "Invalid preview frame rate" };
+    }
+    _sink.copyStream(source_stream);
+    _sink_index = int(_sink.streamNumber()) - 1;
+    std::static_pointer_cast<VideoParameters>(
+        _sink.stream(std::size_t(_sink_index))->params
+    )->setFrameRate(preview_rate);
+}
+
+bool KeyframePassthrough::write(const Packet& packet) {
+    if ((packet.streamIndex() != _source_index) || packet.isEOF()) {
+        return true;
+    }
+    const auto stamp { packet.pts() != AV_NOPTS_VALUE ? packet.pts() : packet.dts() };
+    if (!packet.keyFrame() || (stamp == AV_NOPTS_VALUE)) {
+        _dropped++;
+        return true;
+    }
+    if (_origin == AV_NOPTS_VALUE) {
+        _origin = stamp;
+    }
+    /* one keyframe per preview frame slot, extra ones are dropped */
+    const auto slot {
+        ::av_rescale_q_rnd(stamp - _origin, packet.timeBase(), _preview_time_base
+            , AVRounding(AV_ROUND_NEAR_INF | AV_ROUND_PASS_MINMAX))
+    };
+    if ((_last_slot != AV_NOPTS_VALUE) && (slot <= _last_slot)) {
+        _dropped++;
+        return true;
+    }
+    _last_slot = slot;
+
+    /* intra only - no reordering, dts equals pts */
+    auto preview_packet { packet };
+    preview_packet.setPts(slot);
+    preview_packet.setDts(slot);
+    preview_packet.setDuration(1);
+    preview_packet.setTimeBase(_preview_time_base);
+    preview_packet.setStreamIndex(_sink_index);
+    if (!_sink.write(preview_packet)) {
+        return false;
+    }
+    _forwarded++;
+    return true;
+}
+
+std::int64_t KeyframePassthrough::forwarded() const {
+    return _forwarded;
+}
+
+std::int64_t KeyframePassthrough::dropped() const {
+    return _dropped;
+}
+
+} // namespace fpp
@@ -0,0 +1,36 @@
+#pragma once
+#include <fpp/format/OutputFormatContext.hpp>
+
+namespace fpp {
+
+/* Stream-copies only keyframes of a video stream, at most preview_rate
+ * of them per second, restamped onto the preview frame rate grid.
+ * Produces an I-frame only preview without decoding */
+class KeyframePassthrough {
+
+public:
+
+    KeyframePassthrough(const SharedStream source_stream, OutputFormatContext& sink, AVRational preview_rate);
+
+    /* packets of other streams and non-keyframes are ignored;
+     * false if the sink refused the packet */
+    bool                write(const Packet& packet);
+
+    std::int64_t        forwarded() const;
+    std::int64_t        dropped()   const;
+
+private:
+
+    const int           _source_index;
+    OutputFormatContext& _sink;
+    const AVRational    _preview_time_base;
+    int                 _sink_index;
+
+    std::int64_t        _origin;
+    std::int64_t        _last_slot;
+    std::int64_t        _forwarded;
+    std::int64_t        _dropped;
+
+};
+
+} // namespace fpp
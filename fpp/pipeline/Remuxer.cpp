@@ -0,0 +1,185 @@
+#include "Remuxer.hpp"
+#include <fpp/filter/BitStreamFilterContext.hpp>
+#include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/Utils.hpp>
+
+extern "C" {
+    #include <libavformat/avformat.h>
+}
+
+namespace fpp {
+
+Remuxer::Remuxer(InputFormatContext& source, OutputFormatContext& sink, bool interleaved)
+    : _source { source }
+    , _sink { sink }
+    , _interleaved { interleaved }
+    , _bounded { false }
+    , _written { 0 }
+    , _dropped { 0 } {
+}
+
+std::int64_t Remuxer::remux() {
+    prepare();
+    const auto written_before { _written };
+    /* one instantiation per loop shape, so the interleave and end
+     * point checks are resolved at compile time */
+    if (_interleaved) {
+        _bounded ? loop<true,true>()  : loop<true,false>();
+    } else {
+        _bounded ? loop<false,true>() : loop<false,false>();
+    }
+    const auto sink_streams { _sink.streams() };
+    for (const auto& mapping : _mappings) {
+        if (mapping.output) {
+            const auto& output { sink_streams[std::size_t(mapping.output_index)] };
+            output->setDuration(output->duration() + mapping.duration);
+        }
+    }
+    log_info() << "Remuxed " << (_written - written_before) << " packets, dropped " << _dropped;
+    return _written - written_before;
+}
+
+std::int64_t Remuxer::written() const {
+    return _written;
+}
+
+std::int64_t Remuxer::dropped() const {
+    return _dropped;
+}
+
+void Remuxer::prepare() {
+    if (_sink.streams().empty()) {
+        for (const auto& input_stream : _source.streams()) {
+            _sink.copyStream(input_stream);
+        }
+    }
+    if (!_sink.opened() && !_sink.open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(_sink.mediaResourceLocator()) };
+    }
+
+    const auto sink_streams { _sink.streams() };
+    _mappings.clear();
+    _bounded = false;
+    for (const auto& input_stream : _source.streams()) {
+        Mapping mapping {};
+        const auto index { std::size_t(input_stream->index()) };
+        mapping.type = input_stream->type();
+        mapping.in_time_base = input_stream->raw()->time_base;
+        mapping.end = TO_END;
+        if (index < sink_streams.size()) {
+            const auto& output_stream { sink_streams[index] };
+            mapping.output = output_stream->raw();
+            mapping.output_index = output_stream->index();
+            /* the muxer may change the time base in avformat_write_header */
+            const auto out_time_base { output_stream->raw()->time_base };
+            mapping.rescaler = Rescaler { mapping.in_time_base, out_time_base };
+            if (const auto bitstream_filter { _sink.bitstreamFilter(index) }) {
+                mapping.bitstream_filter = bitstream_filter.get();
+                mapping.filter_rescaler = Rescaler { bitstream_filter->timeBaseOut(), out_time_base };
+            }
+        } else {
+            log_warning() << "Stream #" << index << " has no sink stream, dropped";
+        }
+        if (input_stream->endTimePoint() != TO_END) {
+            const auto origin {
+                input_stream->raw()->start_time != NOPTS_VALUE ? input_stream->raw()->start_time : 0
+            };
+            mapping.end = origin + ::av_rescale_q(
+                input_stream->endTimePoint()
+                , DEFAULT_TIME_BASE
+                , mapping.in_time_base
+            );
+            _bounded = true;
+        }
+        if (index >= _mappings.size()) {
+            _mappings.resize(index + 1);
+        }
+        _mappings[index] = mapping;
+    }
+}
+
+template <bool Interleaved, bool Bounded>
+void Remuxer::loop() {
+    const auto read_timeout  { _source.getTimeout(FormatContext::TimeoutProcess::Reading) };
+    const auto write_timeout { _sink.getTimeout(FormatContext::TimeoutProcess::Writing)   };
+    const auto mappings_size { _mappings.size() };
+    const auto mappings      { _mappings.data() };
+
+    Packet packet;
+    const auto avpacket { packet.ptr() };
+    while (true) {
+        _source.setInterruptTimeout(read_timeout);
+        if (const auto ret { ::av_read_frame(_source.raw(), avpacket) }; ret < 0) {
+            if (ERROR_EOF == ret) {
+                return;
+            }
+            throw FFmpegException {
+                "Cannot read source: " + utils::quoted(_source.mediaResourceLocator()) + std::to_string(ret)
+            };
+        }
+        const auto index { std::size_t(avpacket->stream_index) };
+        if ((index >= mappings_size) || !mappings[index].output) {
+            ::av_packet_unref(avpacket);
+            ++_dropped;
+            continue;
+        }
+        auto& mapping { mappings[index] };
+        if constexpr (Bounded) {
+            const auto stamp {
+                avpacket->pts != NOPTS_VALUE ? avpacket->pts : avpacket->dts
+            };
+            if ((stamp != NOPTS_VALUE) && (stamp >= mapping.end)) {
+                ::av_packet_unref(avpacket);
+                log_info() << "End time point reached on stream #" << index;
+                return;
+            }
+        }
+        _sink.setInterruptTimeout(write_timeout);
+        if (mapping.bitstream_filter) {
+            writeFiltered<Interleaved>(mapping, packet);
+            continue;
+        }
+        mapping.rescaler.rescale(avpacket);
+        avpacket->stream_index = mapping.output_index;
+        avpacket->pos = -1;
+        mapping.duration += avpacket->duration;
+        writeRaw<Interleaved>(avpacket);
+        ++_written;
+    }
+}
+
+template <bool Interleaved>
+void Remuxer::writeFiltered(Mapping& mapping, Packet& packet) {
+    packet.setType(mapping.type);
+    packet.setTimeBase(mapping.in_time_base);
+    for (auto& filtered : mapping.bitstream_filter->filter(std::move(packet))) {
+        const auto avpacket { filtered.ptr() };
+        mapping.filter_rescaler.rescale(avpacket);
+        avpacket->stream_index = mapping.output_index;
+        avpacket->pos = -1;
+        mapping.duration += avpacket->duration;
+        writeRaw<Interleaved>(avpacket);
+        ++_written;
+    }
+}
+
+template <bool Interleaved>
+void Remuxer::writeRaw(AVPacket* packet) {
+    const auto stream_index { packet->stream_index };
+    auto ret { 0 };
+    if constexpr (Interleaved) {
+        /* takes ownership of the packet's data */
+        ret = ::av_interleaved_write_frame(_sink.raw(), packet);
+    } else {
+        ret = ::av_write_frame(_sink.raw(), packet);
+        ::av_packet_unref(packet);
+    }
+    if (ret < 0) {
+        throw FFmpegException {
+            "Failed to write packet of stream #" + std::to_string(stream_index)
+            + " to " + utils::quoted(_sink.mediaResourceLocator()) + ": " + std::to_string(ret)
+        };
+    }
+}
+
+} // namespace fpp
@@ -0,0 +1,67 @@
+#pragma once
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/core/time/Rescaler.hpp>
+
+namespace fpp {
+
+/* Stream-copy loop without the per-packet bookkeeping of read() and
+ * write(): stream mappings, time base pairs and end points are resolved
+ * once, then packets go from av_read_frame to the muxer through raw
+ * stream pointers. Source stream i is written to sink stream i, sink
+ * streams are copied from the source if the sink has none. End time
+ * points of the source streams are honoured, start points, stamp
+ * offsets and latency tracing are not */
+class Remuxer : public Object {
+
+public:
+
+    Remuxer(InputFormatContext& source, OutputFormatContext& sink, bool interleaved = true);
+
+    /* opens the sink if needed, returns the number of written packets */
+    std::int64_t        remux();
+
+    std::int64_t        written() const;
+    /* packets of streams without a sink stream, write errors throw */
+    std::int64_t        dropped() const;
+
+private:
+
+    struct Mapping {
+        AVStream*       output;         ///< nullptr if the stream is dropped
+        int             output_index;
+        AVRational      in_time_base;
+        Rescaler        rescaler;       ///< source -> sink time base
+        std::int64_t    end;            ///< end time point, source time base
+        std::int64_t    duration;       ///< written, output time base
+        BitStreamFilterContext* bitstream_filter;
+        Rescaler        filter_rescaler; ///< filter output -> sink time base
+        Media::Type     type;
+    };
+
+    void                prepare();
+
+    template <bool Interleaved>
+    void                writeFiltered(Mapping& mapping, Packet& packet);
+
+    template <bool Interleaved>
+    void                writeRaw(AVPacket* packet);
+
+    template <bool Interleaved, bool Bounded>
+    void                loop();
+
+private:
+
+    InputFormatContext& _source;
+    OutputFormatContext& _sink;
+    const bool          _interleaved;
+
+    std::vector<Mapping> _mappings;
+    bool                _bounded;
+
+    std::int64_t        _written;
+    std::int64_t        _dropped;
+
+};
+
+} // namespace fpp
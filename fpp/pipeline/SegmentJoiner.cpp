@@ -0,0 +1,60 @@
+#include "SegmentJoiner.hpp"
+#include <fpp/core/Utils.hpp>
+
+extern "C" {
+    #include <libavutil/mathematics.h>
+}
+
+namespace fpp {
+
+SegmentJoiner::SegmentJoiner()
+    : _time_base { DEFAULT_RATIONAL }
+    , _offset { 0 }
+    , _last_dts { NOPTS_VALUE }
+    , _segment_started { true } {
+}
+
+void SegmentJoiner::startSegment() {
+    _segment_started = true;
+}
+
+void SegmentJoiner::shiftVideo(Packet& packet) {
+    if (not_inited_q(_time_base)) {
+        _time_base = packet.timeBase();
+    }
+    /* encoder delay or reordering makes a segment start behind the
+     * previous one, the offset is raised once per segment */
+    if (_segment_started && (packet.dts() != NOPTS_VALUE)) {
+        _segment_started = false;
+        const auto dts { shifted(packet.dts(), packet.timeBase()) };
+        const auto last_dts { ::av_rescale_q(_last_dts, _time_base, packet.timeBase()) };
+        if ((_last_dts != NOPTS_VALUE) && (dts <= last_dts)) {
+            _offset += ::av_rescale_q(last_dts + 1 - dts, packet.timeBase(), _time_base);
+        }
+    }
+    shift(packet);
+    if (packet.dts() != NOPTS_VALUE) {
+        _last_dts = ::av_rescale_q(packet.dts(), packet.timeBase(), _time_base);
+    }
+}
+
+void SegmentJoiner::shift(Packet& packet) const {
+    if (_offset == 0) {
+        return;
+    }
+    if (packet.dts() != NOPTS_VALUE) {
+        packet.setDts(shifted(packet.dts(), packet.timeBase()));
+    }
+    if (packet.pts() != NOPTS_VALUE) {
+        packet.setPts(shifted(packet.pts(), packet.timeBase()));
+    }
+}
+
+std::int64_t SegmentJoiner::shifted(std::int64_t stamp, AVRational time_base) const {
+    if ((_offset == 0) || (stamp == NOPTS_VALUE)) {
+        return stamp;
+    }
+    return stamp + ::av_rescale_q(_offset, _time_base, time_base);
+}
+
+} // namespace fpp
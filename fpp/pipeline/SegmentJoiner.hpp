@@ -0,0 +1,35 @@
+#pragma once
+#include <fpp/base/Packet.hpp>
+
+namespace fpp {
+
+/* Keeps video dts monotonic where separately encoded or copied
+ * segments are joined. When a segment's first dts overlaps the
+ * previous segment the offset of the whole output grows, and every
+ * stream written afterwards is shifted by it, so audio stays in sync
+ * with the shifted video */
+class SegmentJoiner {
+
+public:
+
+    SegmentJoiner();
+
+    /* the next video packet begins a new segment */
+    void                startSegment();
+
+    void                shiftVideo(Packet& packet);
+    void                shift(Packet& packet) const;
+
+    /* stamp as shift() would write it, for interleaving decisions */
+    std::int64_t        shifted(std::int64_t stamp, AVRational time_base) const;
+
+private:
+
+    AVRational          _time_base;         ///< video, taken from its first packet
+    std::int64_t        _offset;            ///< video time base
+    std::int64_t        _last_dts;
+    bool                _segment_started;
+
+};
+
+} // namespace fpp
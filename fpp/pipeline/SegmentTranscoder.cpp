@@ -0,0 +1,292 @@
+#include "SegmentTranscoder.hpp"
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/codec/DecoderContext.hpp>
+#include <fpp/codec/EncoderContext.hpp>
+#include <fpp/scale/RescaleContext.hpp>
+#include <fpp/pipeline/SegmentJoiner.hpp>
+#include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/Utils.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <future>
+
+extern "C" {
+    #include <libavformat/avformat.h>
+}
+
+namespace fpp {
+
+namespace {
+
+/* stitching reads only the needed streams */
+void discard_streams_except(InputFormatContext& input, AVMediaType type) {
+    for (auto i { 0u }; i < input.raw()->nb_streams; ++i) {
+        const auto av_stream { input.raw()->streams[i] };
+        if (av_stream->codecpar->codec_type != type) {
+            av_stream->discard = AVDISCARD_ALL;
+        }
+    }
+}
+
+bool has_stream(InputFormatContext& input, AVMediaType type) {
+    for (auto i { 0u }; i < input.raw()->nb_streams; ++i) {
+        if (input.raw()->streams[i]->codecpar->codec_type == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+SegmentTranscoder::SegmentTranscoder(const std::string_view source_mrl
+                                   , const std::string_view sink_mrl
+                                   , const SpVideoParameters video_params)
+    : SegmentTranscoder(source_mrl, sink_mrl, video_params, Settings {}) {
+}
+
+SegmentTranscoder::SegmentTranscoder(const std::string_view source_mrl
+                                   , const std::string_view sink_mrl
+                                   , const SpVideoParameters video_params
+                                   , Settings settings)
+    : _source_mrl { source_mrl }
+    , _sink_mrl { sink_mrl }
+    , _video_params { video_params }
+    , _settings { settings } {
+}
+
+void SegmentTranscoder::transcode() {
+    const auto chunks { split() };
+
+    std::vector<std::future<void>> workers;
+    for (std::size_t i { 0 }; i < chunks.size(); ++i) {
+        workers.push_back(
+            std::async(std::launch::async
+                , [this,i,chunk=chunks[i]]() { transcodeChunk(i, chunk); }
+            )
+        );
+    }
+    for (auto& worker : workers) {
+        worker.get();
+    }
+
+    stitch(chunks.size());
+    if (!_settings.keep_chunks) {
+        removeChunks(chunks.size());
+    }
+}
+
+SegmentTranscoder::ChunkVector SegmentTranscoder::split() const {
+    InputFormatContext source { _source_mrl };
+    source.setKeyframeIndexing(true);
+    if (!source.open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(_source_mrl) };
+    }
+    const auto stream_index { source.stream(Media::Type::Video)->index() };
+    const auto keyframes { source.keyframeIndex().entries(stream_index) };
+    if (keyframes.empty()) {
+        throw FFmpegException { "No keyframes found in " + utils::quoted(_source_mrl) };
+    }
+
+    /* evenly spaced boundaries snapped to the preceding keyframe */
+    const auto first { keyframes.front().pts };
+    const auto last  { keyframes.back().pts  };
+    const auto count { std::max(_settings.chunks, std::size_t { 1 }) };
+
+    std::vector<std::int64_t> starts { first };
+    for (std::size_t i { 1 }; i < count; ++i) {
+        const auto target { first + (last - first) * std::int64_t(i) / std::int64_t(count) };
+        const auto keyframe { source.keyframeIndex().findPreceding(stream_index, target) };
+        if (keyframe && (keyframe->pts > starts.back())) {
+            starts.push_back(keyframe->pts);
+        }
+    }
+
+    ChunkVector chunks;
+    for (std::size_t i { 0 }; i < starts.size(); ++i) {
+        const auto end {
+            (i + 1 < starts.size()) ? starts[i + 1] : AV_NOPTS_VALUE
+        };
+        chunks.push_back({ starts[i], end });
+    }
+    return chunks;
+}
+
+void SegmentTranscoder::transcodeChunk(std::size_t index, const Chunk& chunk) const {
+    InputFormatContext source { _source_mrl };
+    if (!source.open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(_source_mrl) };
+    }
+    discard_streams_except(source, AVMEDIA_TYPE_VIDEO);
+
+    const auto in_stream    { source.stream(Media::Type::Video) };
+    const auto stream_index { in_stream->index() };
+    if (index != 0) {
+        source.seek(stream_index, chunk.start, InputFormatContext::SeekPrecision::Backward);
+    }
+
+    OutputFormatContext sink { chunkName(index), "nut" };
+    const auto out_params { std::make_shared<VideoParameters>(*_video_params) };
+    out_params->completeFrom(in_stream->params);
+    sink.createStream(out_params);
+
+    DecoderContext decoder { in_stream->params };
+
+    /* chunks must not reference frames of each other */
+    auto options { _settings.encoder_options };
+    options.push_back({ "flags", "+cgop" });
+    EncoderContext encoder { sink.stream(0)->params, options };
+
+    const InOutParams rescale_params { in_stream->params, sink.stream(0)->params };
+    std::unique_ptr<RescaleContext> rescaler;
+    if (utils::rescaling_required(rescale_params)) {
+        rescaler = std::make_unique<RescaleContext>(rescale_params);
+    }
+
+    if (!sink.open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(chunkName(index)) };
+    }
+
+    const auto write_packets {
+        [&](PacketVector packets) {
+            for (auto& packet : packets) {
+                packet.setStreamIndex(0);
+                if (!sink.write(packet)) {
+                    throw FFmpegException { "Failed to write packet to " + utils::quoted(chunkName(index)) };
+                }
+            }
+        }
+    };
+
+    /* frames before the start are leading frames of an open gop, the
+     * previous chunk owns them; the first frame at the end is the next
+     * chunk's keyframe and completes this one */
+    auto done { false };
+    const auto encode_frames {
+        [&](const FrameVector& frames) {
+            for (auto frame : frames) {
+                const auto pts { frame.raw().best_effort_timestamp };
+                if (pts < chunk.start) {
+                    continue;
+                }
+                if ((chunk.end != AV_NOPTS_VALUE) && (pts >= chunk.end)) {
+                    done = true;
+                    return;
+                }
+                frame.setPts(pts);
+                write_packets(encoder.encode(rescaler ? rescaler->scale(frame) : frame));
+            }
+        }
+    };
+
+    while (!done) {
+        const auto packet { source.read() };
+        if (packet.isEOF()) {
+            encode_frames(decoder.flush(in_stream->params->timeBase(), stream_index));
+            break;
+        }
+        if (packet.streamIndex() == stream_index) {
+            encode_frames(decoder.decode(packet));
+        }
+    }
+    write_packets(encoder.flush(in_stream->params->timeBase(), 0));
+
+    sink.close();
+}
+
+void SegmentTranscoder::stitch(std::size_t chunk_count) const {
+    InputFormatContext source { _source_mrl };
+    if (!source.open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(_source_mrl) };
+    }
+    discard_streams_except(source, AVMEDIA_TYPE_AUDIO);
+    const auto with_audio { has_stream(source, AVMEDIA_TYPE_AUDIO) };
+
+    std::size_t chunk_index { 0 };
+    auto chunk { std::make_unique<InputFormatContext>(chunkName(chunk_index)) };
+    if (!chunk->open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(chunkName(chunk_index)) };
+    }
+
+    /* extradata comes from the chunk encoders, equal for equal settings */
+    OutputFormatContext sink { _sink_mrl };
+    sink.copyStream(chunk->stream(Media::Type::Video));
+    if (with_audio) {
+        sink.copyStream(source.stream(Media::Type::Audio));
+    }
+    if (!sink.open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(_sink_mrl) };
+    }
+
+    /* audio is shifted with the chunks, or it drifts ahead by the
+     * accumulated encoder delay */
+    SegmentJoiner joiner;
+
+    const auto read_video {
+        [&]() {
+            while (true) {
+                auto packet { chunk->read() };
+                if (packet.isEOF()) {
+                    if (++chunk_index == chunk_count) {
+                        return packet;
+                    }
+                    chunk = std::make_unique<InputFormatContext>(chunkName(chunk_index));
+                    if (!chunk->open()) {
+                        throw FFmpegException { "Failed to open " + utils::quoted(chunkName(chunk_index)) };
+                    }
+                    joiner.startSegment();
+                    continue;
+                }
+                joiner.shiftVideo(packet);
+                return packet;
+            }
+        }
+    };
+    const auto write {
+        [&](Packet& packet, int stream_index) {
+            packet.setStreamIndex(stream_index);
+            if (!sink.interleavedWrite(packet)) {
+                throw FFmpegException {
+                    "Failed to write packet of stream #" + std::to_string(stream_index)
+                    + " to " + utils::quoted(_sink_mrl)
+                };
+            }
+        }
+    };
+
+    auto video { read_video() };
+    auto audio { with_audio ? source.read() : Packet { Media::Type::EndOF } };
+
+    while (!video.isEOF() || !audio.isEOF()) {
+        const auto video_first {
+            audio.isEOF()
+            || (!video.isEOF()
+                && (::av_compare_ts(
+                    video.dts(), video.timeBase()
+                    , joiner.shifted(audio.dts(), audio.timeBase()), audio.timeBase()) <= 0))
+        };
+        if (video_first) {
+            write(video, 0);
+            video = read_video();
+        } else {
+            joiner.shift(audio);
+            write(audio, 1);
+            audio = source.read();
+        }
+    }
+
+    sink.close();
+}
+
+void SegmentTranscoder::removeChunks(std::size_t chunk_count) const {
+    for (std::size_t i { 0 }; i < chunk_count; ++i) {
+        std::remove(chunkName(i).c_str());
+    }
+}
+
+std::string SegmentTranscoder::chunkName(std::size_t index) const {
+    return _sink_mrl + ".chunk" + std::to_string(index) + ".nut";
+}
+
+} // namespace fpp
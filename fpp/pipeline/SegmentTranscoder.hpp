@@ -0,0 +1,57 @@
+#pragma once
+#include <fpp/stream/VideoParameters.hpp>
+#include <fpp/base/Dictionary.hpp>
+#include <fpp/base/Packet.hpp>
+#include <thread>
+
+namespace fpp {
+
+/* File to file transcoding split at keyframes into time ranges, each
+ * range transcoded by its own input/decoder/encoder set in parallel,
+ * then stitched into one output. Video is transcoded, the first audio
+ * stream is copied from the source while stitching */
+class SegmentTranscoder {
+
+public:
+
+    struct Settings {
+        std::size_t     chunks          { std::thread::hardware_concurrency() };
+        Options         encoder_options {};
+        bool            keep_chunks     { false };
+    };
+
+    SegmentTranscoder(const std::string_view source_mrl
+                    , const std::string_view sink_mrl
+                    , const SpVideoParameters video_params);
+    SegmentTranscoder(const std::string_view source_mrl
+                    , const std::string_view sink_mrl
+                    , const SpVideoParameters video_params
+                    , Settings settings);
+
+    void                transcode();
+
+private:
+
+    struct Chunk {
+        std::int64_t    start;  ///< first keyframe pts, source stream time base
+        std::int64_t    end;    ///< next chunk start or AV_NOPTS_VALUE
+    };
+
+    using ChunkVector = std::vector<Chunk>;
+
+    ChunkVector         split() const;
+    void                transcodeChunk(std::size_t index, const Chunk& chunk) const;
+    void                stitch(std::size_t chunk_count) const;
+    void                removeChunks(std::size_t chunk_count) const;
+    std::string         chunkName(std::size_t index) const;
+
+private:
+
+    const std::string   _source_mrl;
+    const std::string   _sink_mrl;
+    const SpVideoParameters _video_params;
+    const Settings      _settings;
+
+};
+
+} // namespace fpp
@@ -0,0 +1,110 @@
+#include "SharedEncoderOutput.hpp"
+#include <fpp/stream/VideoParameters.hpp>
+#include <fpp/stream/AudioParameters.hpp>
+#include <fpp/core/FFmpegException.hpp>
+
+extern "C" {
+    #include <libavformat/avformat.h>
+}
+
+namespace fpp {
+
+namespace {
+
+SpParameters clone_params(const SpParameters& params) {
+    if (params->isVideo()) {
+        return std::make_shared<VideoParameters>(*std::static_pointer_cast<VideoParameters>(params));
+    }
+    if (params->isAudio()) {
+        return std::make_shared<AudioParameters>(*std::static_pointer_cast<AudioParameters>(params));
+    }
+    return std::make_shared<Parameters>(*params);
+}
+
+} // namespace
+
+SharedEncoderOutput::SharedEncoderOutput(const SpParameters params, Options options)
+    : params { params }
+    , _options { std::move(options) }
+    , _time_base { params->timeBase() } {
+}
+
+void SharedEncoderOutput::addSink(OutputFormatContext& sink, const std::string_view bitstream_filter) {
+    if (_encoder) {
+        throw FFmpegException { "Cannot add sink to opened shared encoder" };
+    }
+    _sinks.push_back({ &sink, std::string { bitstream_filter }, nullptr, -1 });
+}
+
+bool SharedEncoderOutput::open(const Options& sink_options) {
+    if (_sinks.empty()) {
+        throw FFmpegException { "Shared encoder has no sinks" };
+    }
+
+    /* global header if any sink wants it, the others get a bitstream filter */
+    auto format_flags { 0 };
+    for (const auto& sink : _sinks) {
+        format_flags |= sink.context->outputFormat()->flags;
+    }
+    params->setFormatFlags(format_flags);
+    _encoder = std::make_unique<EncoderContext>(params, _options);
+
+    for (auto& sink : _sinks) {
+        const auto sink_params { clone_params(params) };
+        if (!sink.bitstream_filter_name.empty()) {
+            sink.bitstream_filter = std::make_unique<BitStreamFilterContext>(
+                params, sink.bitstream_filter_name
+            );
+            sink_params->parseCodecpar(sink.bitstream_filter->raw()->par_out);
+        }
+        sink.context->createStream(sink_params);
+        sink.stream_index = int(sink.context->streamNumber()) - 1;
+        if (!sink.context->open(sink_options)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SharedEncoderOutput::close() {
+    for (auto& sink : _sinks) {
+        sink.context->close();
+    }
+}
+
+void SharedEncoderOutput::encode(const Frame& frame) {
+    _time_base = frame.timeBase();
+    write(_encoder->encode(frame));
+}
+
+void SharedEncoderOutput::flush() {
+    write(_encoder->flush(_time_base, 0));
+    for (auto& sink : _sinks) {
+        if (sink.bitstream_filter) {
+            write(sink, sink.bitstream_filter->flush());
+        }
+    }
+}
+
+void SharedEncoderOutput::write(const PacketVector& packets) {
+    for (const auto& packet : packets) {
+        for (auto& sink : _sinks) {
+            /* each sink stamps its own reference */
+            if (sink.bitstream_filter) {
+                write(sink, sink.bitstream_filter->filter(packet));
+            }
+            else {
+                write(sink, { packet });
+            }
+        }
+    }
+}
+
+void SharedEncoderOutput::write(Sink& sink, PacketVector&& packets) {
+    for (auto& packet : packets) {
+        packet.setStreamIndex(sink.stream_index);
+        sink.context->interleavedWrite(packet);
+    }
+}
+
+} // namespace fpp
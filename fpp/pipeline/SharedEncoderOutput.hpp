@@ -0,0 +1,51 @@
+#pragma once
+#include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/codec/EncoderContext.hpp>
+#include <fpp/filter/BitStreamFilterContext.hpp>
+#include <memory>
+
+namespace fpp {
+
+/* One encoder feeding several sinks: every frame is encoded once and
+ * the packet is muxed to each sink, optionally through a per-sink
+ * bitstream filter. Time base rescaling is done per sink by its Stream */
+class SharedEncoderOutput {
+
+public:
+
+    explicit SharedEncoderOutput(const SpParameters params, Options options = {});
+
+    /* before open(); sink must not be opened */
+    void                addSink(OutputFormatContext& sink, const std::string_view bitstream_filter = {});
+
+    /* opens the encoder, creates a stream in every sink and opens them */
+    bool                open(const Options& sink_options = {});
+    void                close();
+
+    void                encode(const Frame& frame);
+    void                flush();
+
+    const SpParameters  params;
+
+private:
+
+    struct Sink {
+        OutputFormatContext*    context;
+        std::string             bitstream_filter_name;
+        std::unique_ptr<BitStreamFilterContext> bitstream_filter;
+        int                     stream_index;
+    };
+
+    void                write(const PacketVector& packets);
+    void                write(Sink& sink, PacketVector&& packets);
+
+private:
+
+    const Options       _options;
+    AVRational          _time_base;
+    std::unique_ptr<EncoderContext> _encoder;
+    std::vector<Sink>   _sinks;
+
+};
+
+} // namespace fpp
@@ -0,0 +1,284 @@
+#include "ThumbnailExtractor.hpp"
+#include <fpp/codec/DecoderContext.hpp>
+#include <fpp/codec/EncoderContext.hpp>
+#include <fpp/scale/RescaleContext.hpp>
+#include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/Utils.hpp>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <future>
+
+extern "C" {
+    #include <libavformat/avformat.h>
+    #include <libavutil/imgutils.h>
+    #include <libavutil/pixdesc.h>
+}
+
+namespace fpp {
+
+ThumbnailExtractor::ThumbnailExtractor(InputFormatContext& source)
+    : ThumbnailExtractor(source, Settings {}) {
+}
+
+ThumbnailExtractor::ThumbnailExtractor(InputFormatContext& source, Settings settings)
+    : _mrl { source.mediaResourceLocator() }
+    , _format_name { source.inputFormat() ? source.inputFormat()->name : "" }
+    , _duration {
+        source.raw()->duration != AV_NOPTS_VALUE
+            ? ::av_rescale_q(source.raw()->duration, AV_TIME_BASE_Q, DEFAULT_TIME_BASE)
+            : 0
+    }
+    , _source_params {
+        std::static_pointer_cast<VideoParameters>(source.stream(Media::Type::Video)->params)
+    }
+    , _settings { settings } {
+}
+
+ThumbnailExtractor::ThumbnailVector ThumbnailExtractor::extract(std::vector<std::int64_t> timestamps) const {
+    ThumbnailVector thumbnails;
+    for (auto& keyframe : extractParallel(std::move(timestamps), true)) {
+        thumbnails.push_back({ keyframe.timestamp, keyframe.pts, keyframe.image });
+    }
+    return thumbnails;
+}
+
+ThumbnailExtractor::ThumbnailVector ThumbnailExtractor::extract(std::int64_t interval) const {
+    return extract(intervalTimestamps(interval));
+}
+
+Packet ThumbnailExtractor::spriteSheet(std::vector<std::int64_t> timestamps, std::size_t columns) const {
+    const auto keyframes { extractParallel(std::move(timestamps), false) };
+    if (keyframes.empty() || (columns == 0)) {
+        return Packet { Media::Type::EndOF };
+    }
+    auto sheet { tile(keyframes, columns) };
+    EncoderContext encoder {
+        createImageParams(sheet.raw().width, sheet.raw().height), encoderOptions()
+    };
+    auto packets { encoder.encode(sheet) };
+    if (packets.empty()) {
+        packets = encoder.flush(DEFAULT_TIME_BASE, 0);
+    }
+    return packets.empty() ? Packet { Media::Type::EndOF } : packets.front();
+}
+
+Packet ThumbnailExtractor::spriteSheet(std::int64_t interval, std::size_t columns) const {
+    return spriteSheet(intervalTimestamps(interval), columns);
+}
+
+bool ThumbnailExtractor::save(const Packet& image, const std::string_view file_name) {
+    if (image.isEOF() || (image.size() <= 0)) {
+        return false;
+    }
+    std::ofstream file { std::string { file_name }, std::ios::binary };
+    file.write(reinterpret_cast<const char*>(image.raw().data), image.size());
+    return bool(file);
+}
+
+std::vector<std::int64_t> ThumbnailExtractor::intervalTimestamps(std::int64_t interval) const {
+    if (interval <= 0) {
+        throw FFmpegException { "Thumbnail interval must be positive" };
+    }
+    std::vector<std::int64_t> timestamps;
+    for (std::int64_t ts { 0 }; ts < std::max(_duration, std::int64_t { 1 }); ts += interval) {
+        timestamps.push_back(ts);
+    }
+    return timestamps;
+}
+
+ThumbnailExtractor::KeyframeVector ThumbnailExtractor::extractParallel(std::vector<std::int64_t> timestamps, bool encode) const {
+    std::sort(timestamps.begin(), timestamps.end());
+    if (timestamps.empty()) {
+        return {};
+    }
+
+    /* contiguous ranges keep each worker seeking forward only */
+    const auto workers {
+        std::clamp(_settings.workers, std::size_t { 1 }, timestamps.size())
+    };
+    const auto range_size { (timestamps.size() + workers - 1) / workers };
+
+    std::vector<std::future<KeyframeVector>> results;
+    for (std::size_t begin { 0 }; begin < timestamps.size(); begin += range_size) {
+        const auto end { std::min(begin + range_size, timestamps.size()) };
+        results.push_back(
+            std::async(std::launch::async
+                , [this,encode,range=std::vector<std::int64_t>(timestamps.begin() + std::ptrdiff_t(begin)
+                                                             , timestamps.begin() + std::ptrdiff_t(end))]() {
+                    return extractRange(range, encode);
+                }
+            )
+        );
+    }
+
+    KeyframeVector keyframes;
+    for (auto& result : results) {
+        auto range_keyframes { result.get() };
+        std::move(range_keyframes.begin(), range_keyframes.end(), std::back_inserter(keyframes));
+    }
+    return keyframes;
+}
+
+ThumbnailExtractor::KeyframeVector ThumbnailExtractor::extractRange(const std::vector<std::int64_t>& timestamps, bool encode) const {
+    InputFormatContext input { _mrl, _format_name };
+    if (!input.open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(_mrl) };
+    }
+    const auto in_params { input.stream(Media::Type::Video)->params };
+
+    /* parallelism comes from workers, one codec thread each */
+    DecoderContext decoder { in_params, {{ "threads", "1" }} };
+    decoder.setDecodeMode(DecoderContext::DecodeMode::KeyframesOnly);
+
+    const auto image_params { createImageParams(_settings.width, _settings.height) };
+    RescaleContext rescaler {{ in_params, image_params }};
+    std::unique_ptr<EncoderContext> encoder;
+    if (encode) {
+        encoder = std::make_unique<EncoderContext>(image_params, encoderOptions());
+    }
+
+    KeyframeVector keyframes;
+    for (const auto timestamp : timestamps) {
+        const auto frame { decodeKeyframe(input, decoder, timestamp) };
+        if (frame.isEOF()) {
+            continue;
+        }
+        const auto pts {
+            ::av_rescale_q(frame.raw().best_effort_timestamp, frame.timeBase(), DEFAULT_TIME_BASE)
+        };
+        /* dense timestamps often resolve to the same keyframe */
+        if (!keyframes.empty() && (keyframes.back().pts == pts)) {
+            auto same { keyframes.back() };
+            same.timestamp = timestamp;
+            keyframes.push_back(same);
+            continue;
+        }
+        Keyframe keyframe { timestamp, pts, rescaler.scale(frame), Packet { Media::Type::EndOF } };
+        if (encoder) {
+            keyframe.frame.setPts(0);
+            if (auto packets { encoder->encode(keyframe.frame) }; !packets.empty()) {
+                keyframe.image = packets.front();
+            }
+        }
+        keyframes.push_back(keyframe);
+    }
+    return keyframes;
+}
+
+Frame ThumbnailExtractor::decodeKeyframe(InputFormatContext& input, DecoderContext& decoder, std::int64_t timestamp) const {
+    const auto video_stream { input.stream(Media::Type::Video) };
+    const auto stream_index { video_stream->index() };
+    const auto time_base { video_stream->params->timeBase() };
+
+    if (!input.seek(stream_index
+                  , ::av_rescale_q(timestamp, DEFAULT_TIME_BASE, time_base)
+                  , InputFormatContext::SeekPrecision::Backward)) {
+        return Frame { Media::Type::EndOF };
+    }
+    decoder.flushBuffers();
+
+    while (true) {
+        const auto packet { input.read() };
+        const auto frames {
+            packet.isEOF()
+                ? decoder.flush(time_base, stream_index)
+                : (packet.streamIndex() == stream_index)
+                    ? decoder.decode(packet)
+                    : FrameVector {}
+        };
+        if (!frames.empty()) {
+            return frames.front();
+        }
+        if (packet.isEOF()) {
+            return Frame { Media::Type::EndOF };
+        }
+    }
+}
+
+SpVideoParameters ThumbnailExtractor::createImageParams(int width, int height) const {
+    const auto source_width  { _source_params->width()  };
+    const auto source_height { _source_params->height() };
+    if (height <= 0) {
+        height = int(std::int64_t(width) * source_height / std::max(source_width, 1));
+    }
+    /* chroma subsampled formats require even dimensions */
+    width  += width  % 2;
+    height += height % 2;
+
+    auto params { VideoParameters::make_shared() };
+    switch (_settings.format) {
+        case ImageFormat::Jpeg:
+            params->setEncoder(AV_CODEC_ID_MJPEG);
+            params->setPixelFormat(AV_PIX_FMT_YUVJ420P);
+            break;
+        case ImageFormat::Png:
+            params->setEncoder(AV_CODEC_ID_PNG);
+            params->setPixelFormat(AV_PIX_FMT_RGB24);
+            break;
+    }
+    params->setWidth(width);
+    params->setHeight(height);
+    params->setGopSize(1);
+    params->completeFrom(_source_params);
+    return params;
+}
+
+Options ThumbnailExtractor::encoderOptions() const {
+    if (_settings.format == ImageFormat::Png) {
+        return {{ "threads", "1" }};
+    }
+    const auto quality { std::to_string(std::clamp(_settings.quality, 2, 31)) };
+    return {
+          { "threads", "1"     }
+        , { "qmin",    quality }
+        , { "qmax",    quality }
+    };
+}
+
+Frame ThumbnailExtractor::tile(const KeyframeVector& keyframes, std::size_t columns) const {
+    const auto& first { keyframes.front().frame.raw() };
+    const auto rows { (keyframes.size() + columns - 1) / columns };
+    const auto format { AVPixelFormat(first.format) };
+    const auto desc { ::av_pix_fmt_desc_get(format) };
+
+    Frame sheet { Media::Type::Video };
+    sheet.raw().format = format;
+    sheet.raw().width  = first.width  * int(std::min(columns, keyframes.size()));
+    sheet.raw().height = first.height * int(rows);
+    constexpr auto align { 32 };
+    ffmpeg_api_strict(av_frame_get_buffer, sheet.ptr(), align);
+
+    /* black background for incomplete last row */
+    const auto yuv { !(desc->flags & AV_PIX_FMT_FLAG_RGB) };
+    for (auto plane { 0 }; plane < 4 && sheet.raw().data[plane]; ++plane) {
+        const auto chroma { yuv && (plane == 1 || plane == 2) };
+        const auto height { chroma ? AV_CEIL_RSHIFT(sheet.raw().height, desc->log2_chroma_h) : sheet.raw().height };
+        std::memset(sheet.raw().data[plane], chroma ? 128 : 0, std::size_t(sheet.raw().linesize[plane] * height));
+    }
+
+    for (std::size_t i { 0 }; i < keyframes.size(); ++i) {
+        const auto& tile { keyframes[i].frame.raw() };
+        const auto x { first.width  * int(i % columns) };
+        const auto y { first.height * int(i / columns) };
+        for (auto plane { 0 }; plane < 4 && tile.data[plane]; ++plane) {
+            const auto chroma { yuv && (plane == 1 || plane == 2) };
+            const auto shift_h { chroma ? desc->log2_chroma_h : 0 };
+            ::av_image_copy_plane(
+                  sheet.raw().data[plane]
+                    + std::ptrdiff_t(y >> shift_h) * sheet.raw().linesize[plane]
+                    + ::av_image_get_linesize(format, x, plane)
+                , sheet.raw().linesize[plane]
+                , tile.data[plane]
+                , tile.linesize[plane]
+                , ::av_image_get_linesize(format, tile.width, plane)
+                , AV_CEIL_RSHIFT(tile.height, shift_h)
+            );
+        }
+    }
+    sheet.setTimeBase(keyframes.front().frame.timeBase());
+    sheet.setPts(0);
+    return sheet;
+}
+
+} // namespace fpp
@@ -0,0 +1,83 @@
+#pragma once
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/stream/VideoParameters.hpp>
+#include <fpp/base/Packet.hpp>
+#include <thread>
+
+namespace fpp {
+
+class DecoderContext;
+class EncoderContext;
+
+/* Extracts keyframe thumbnails in parallel: timestamps are split into
+ * contiguous time ranges, each worker owns its input, keyframe-only
+ * decoder, rescaler and image encoder */
+class ThumbnailExtractor {
+
+public:
+
+    enum class ImageFormat : std::uint8_t {
+          Jpeg
+        , Png
+    };
+
+    struct Settings {
+        int             width       { 160 };
+        int             height      { 0 };  ///< 0 - keep aspect ratio
+        ImageFormat     format      { ImageFormat::Jpeg };
+        int             quality     { 5 };  ///< jpeg qscale, 2 (best) - 31
+        std::size_t     workers     { std::thread::hardware_concurrency() };
+    };
+
+    struct Thumbnail {
+        std::int64_t    timestamp;  ///< requested time, ms
+        std::int64_t    pts;        ///< keyframe pts, ms
+        Packet          image;
+    };
+
+    using ThumbnailVector = std::vector<Thumbnail>;
+
+    explicit ThumbnailExtractor(InputFormatContext& source);
+    ThumbnailExtractor(InputFormatContext& source, Settings settings);
+
+    /* timestamps in milliseconds */
+    ThumbnailVector     extract(std::vector<std::int64_t> timestamps) const;
+    ThumbnailVector     extract(std::int64_t interval) const;
+
+    /* thumbnails tiled row by row into a single image */
+    Packet              spriteSheet(std::vector<std::int64_t> timestamps, std::size_t columns) const;
+    Packet              spriteSheet(std::int64_t interval, std::size_t columns) const;
+
+    static bool         save(const Packet& image, const std::string_view file_name);
+
+private:
+
+    struct Keyframe {
+        std::int64_t    timestamp;
+        std::int64_t    pts;
+        Frame           frame;  ///< rescaled
+        Packet          image;  ///< empty unless encoded
+    };
+
+    using KeyframeVector = std::vector<Keyframe>;
+
+    std::vector<std::int64_t> intervalTimestamps(std::int64_t interval) const;
+    KeyframeVector      extractParallel(std::vector<std::int64_t> timestamps, bool encode) const;
+    KeyframeVector      extractRange(const std::vector<std::int64_t>& timestamps, bool encode) const;
+    Frame               decodeKeyframe(InputFormatContext& input, DecoderContext& decoder, std::int64_t timestamp) const;
+
+    SpVideoParameters   createImageParams(int width, int height) const;
+    Options             encoderOptions() const;
+    Frame               tile(const KeyframeVector& keyframes, std::size_t columns) const;
+
+private:
+
+    const std::string   _mrl;
+    const std::string   _format_name;
+    const std::int64_t  _duration;
+    const SpVideoParameters _source_params;
+    const Settings      _settings;
+
+};
+
+} // namespace fpp
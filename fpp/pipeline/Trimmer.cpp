@@ -0,0 +1,403 @@
+#include "Trimmer.hpp"
+#include <fpp/codec/DecoderContext.hpp>
+#include <fpp/codec/EncoderContext.hpp>
+#include <fpp/stream/VideoParameters.hpp>
+#include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/Utils.hpp>
+#include <algorithm>
+#include <set>
+
+extern "C" {
+    #include <libavformat/avformat.h>
+}
+
+namespace fpp {
+
+namespace {
+
+using NalUnit = std::vector<std::uint8_t>;
+
+/* payloads of an Annex-B buffer, start codes stripped */
+std::vector<std::pair<const std::uint8_t*,std::size_t>>
+split_annexb(const std::uint8_t* data, std::size_t size) {
+    std::vector<std::pair<const std::uint8_t*,std::size_t>> units;
+    const auto start_code_at {
+        [&](std::size_t pos) {
+            return (pos + 3 <= size) && (data[pos] == 0) && (data[pos + 1] == 0) && (data[pos + 2] == 1);
+        }
+    };
+    std::size_t begin { 0 };
+    auto found { false };
+    for (std::size_t pos { 0 }; pos + 3 <= size;) {
+        if (!start_code_at(pos)) {
+            ++pos;
+            continue;
+        }
+        if (found) {
+            auto end { pos };
+            while ((end > begin) && (data[end - 1] == 0)) {
+                --end; /* zero byte of a four byte start code */
+            }
+            units.emplace_back(data + begin, end - begin);
+        }
+        pos += 3;
+        begin = pos;
+        found = true;
+    }
+    if (found && (begin < size)) {
+        units.emplace_back(data + begin, size - begin);
+    }
+    return units;
+}
+
+bool is_annexb(const std::uint8_t* data, std::size_t size) {
+    return (size >= 3) && (data[0] == 0) && (data[1] == 0)
+        && ((data[2] == 1) || ((size >= 4) && (data[2] == 0) && (data[3] == 1)));
+}
+
+/* sorted SPS and PPS of avcC or Annex-B extradata */
+std::vector<NalUnit> h264_parameter_sets(const Extradata& extradata) {
+    const auto [data, size] { extradata };
+    std::vector<NalUnit> sets;
+    if (!data || (size == 0)) {
+        return sets;
+    }
+    if (data[0] == 1) {
+        /* avcC: header, sps count, sps..., pps count, pps... */
+        std::size_t pos { 5 };
+        for (auto list { 0 }; (list < 2) && (pos < size); ++list) {
+            auto count { list == 0 ? (data[pos] & 0x1f) : data[pos] };
+            ++pos;
+            while ((count-- > 0) && (pos + 2 <= size)) {
+                const auto length { std::size_t((data[pos] << 8) | data[pos + 1]) };
+                pos += 2;
+                if (pos + length > size) {
+                    break;
+                }
+                sets.emplace_back(data + pos, data + pos + length);
+                pos += length;
+            }
+        }
+    } else {
+        for (const auto& [nal, nal_size] : split_annexb(data, size)) {
+            const auto nal_type { nal_size > 0 ? (nal[0] & 0x1f) : 0 };
+            if ((nal_type == 7) || (nal_type == 8)) {
+                sets.emplace_back(nal, nal + nal_size);
+            }
+        }
+    }
+    std::sort(sets.begin(), sets.end());
+    return sets;
+}
+
+} // namespace
+
+Trimmer::Trimmer(const std::string_view source_mrl
+               , OutputFormatContext& sink
+               , std::int64_t start
+               , std::int64_t end
+               , Mode mode
+               , Options encoder_options)
+    : _source_mrl { source_mrl }
+    , _sink { sink }
+    , _start { start }
+    , _end { end }
+    , _mode { mode }
+    , _encoder_options { std::move(encoder_options) }
+    , _video_index { -1 }
+    , _nal_length_size { 0 } {
+    if ((start < 0) || (end <= start)) {
+        throw FFmpegException {
+            "Invalid trim range: " + std::to_string(start) + " - " + std::to_string(end)
+        };
+    }
+}
+
+void Trimmer::trim() {
+    InputFormatContext source { _source_mrl };
+    if (_mode == Mode::SmartCut) {
+        source.setKeyframeIndexing(true);
+    }
+    if (!source.open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(_source_mrl) };
+    }
+    auto mode { _mode };
+    if ((mode == Mode::SmartCut) && !edgesMatchSource(source.stream(Media::Type::Video)->params)) {
+        log_warning() << "Re-encoded edges would not match the source stream, "
+                         "falling back to keyframe snap";
+        mode = Mode::KeyframeSnap;
+    }
+    openSink(source);
+    switch (mode) {
+        case Mode::KeyframeSnap: snapCut(source);  break;
+        case Mode::SmartCut:     smartCut(source); break;
+    }
+    _sink.close();
+}
+
+void Trimmer::snapCut(InputFormatContext& source) {
+    for (const auto& source_stream : source.streams()) {
+        source_stream->setStartTimePoint(_start);
+        source_stream->setEndTimePoint(_end);
+    }
+    auto origin_set { false };
+    while (true) {
+        auto packet { source.read() };
+        if (packet.isEOF()) {
+            break;
+        }
+        /* output starts at the snapped keyframe */
+        if (!origin_set && (packet.pts() != AV_NOPTS_VALUE)) {
+            setOrigin(::av_rescale_q(packet.pts(), packet.timeBase(), AV_TIME_BASE_Q));
+            origin_set = true;
+        }
+        write(packet);
+    }
+}
+
+void Trimmer::smartCut(InputFormatContext& source) {
+    const auto video_stream { source.stream(Media::Type::Video) };
+    _video_index = video_stream->index();
+    const auto time_base { video_stream->params->timeBase() };
+
+    const auto format_start {
+        source.raw()->start_time != AV_NOPTS_VALUE ? source.raw()->start_time : 0
+    };
+    const auto start_abs { format_start + ::av_rescale_q(_start, DEFAULT_TIME_BASE, AV_TIME_BASE_Q) };
+    const auto end_abs   { format_start + ::av_rescale_q(_end,   DEFAULT_TIME_BASE, AV_TIME_BASE_Q) };
+    const auto start_pts { ::av_rescale_q(start_abs, AV_TIME_BASE_Q, time_base) };
+    const auto end_pts   { ::av_rescale_q(end_abs,   AV_TIME_BASE_Q, time_base) };
+
+    /* keyframes: k0 <= start <= copy_begin ... copy_end <= end */
+    const auto& index { source.keyframeIndex() };
+    const auto k0 { index.findPreceding(_video_index, start_pts) };
+    if (!k0) {
+        throw FFmpegException { "No keyframes found in " + utils::quoted(_source_mrl) };
+    }
+    const auto keyframes { index.entries(_video_index) };
+    const auto first_inside {
+        std::find_if(keyframes.begin(), keyframes.end()
+            , [start_pts](const KeyframeIndex::Entry& e) { return e.pts >= start_pts; }
+        )
+    };
+    const auto copy_begin { first_inside != keyframes.end() ? first_inside->pts : end_pts };
+    const auto copy_end   { index.findPreceding(_video_index, end_pts)->pts };
+    const auto has_copy   { copy_begin < copy_end };
+
+    /* edges are written in the copied packets' layout */
+    const auto [extradata, extradata_size] { video_stream->params->extradata() };
+    _nal_length_size = (extradata && (extradata_size > 4) && (extradata[0] == 1))
+        ? (extradata[4] & 0x03) + 1
+        : 0;
+
+    setOrigin(start_abs);
+    source.seek(_video_index, k0->pts, InputFormatContext::SeekPrecision::Backward);
+
+    DecoderContext decoder { video_stream->params };
+    std::unique_ptr<EncoderContext> encoder;
+
+    auto phase { (has_copy && (copy_begin == start_pts)) ? Phase::Copy : Phase::Head };
+    const auto head_end { has_copy ? copy_begin : end_pts };
+
+    const auto encode_range {
+        [&](const FrameVector& frames, std::int64_t from, std::int64_t to) {
+            auto range_passed { false };
+            for (auto frame : frames) {
+                const auto pts { frame.raw().best_effort_timestamp };
+                if (pts < from) {
+                    continue;
+                }
+                if (pts >= to) {
+                    range_passed = true;
+                    break;
+                }
+                if (!encoder) {
+                    encoder = createEdgeEncoder(video_stream->params);
+                }
+                frame.setPts(pts);
+                writeVideo(toSourceLayout(encoder->encode(frame)));
+            }
+            return range_passed;
+        }
+    };
+    const auto finish_edge {
+        [&]() {
+            if (encoder) {
+                writeVideo(toSourceLayout(encoder->flush(time_base, _video_index)));
+                encoder.reset();
+            }
+        }
+    };
+
+    std::set<int> finished_streams;
+    const auto stream_count { source.streamNumber() };
+
+    while (finished_streams.size() < stream_count) {
+        auto packet { source.read() };
+        if (packet.isEOF()) {
+            if (phase == Phase::Head) {
+                encode_range(decoder.flush(time_base, _video_index), start_pts, head_end);
+            } else if (phase == Phase::Tail) {
+                encode_range(decoder.flush(time_base, _video_index), copy_end, end_pts);
+            }
+            finish_edge();
+            break;
+        }
+        if (finished_streams.count(packet.streamIndex())) {
+            continue;
+        }
+        if (packet.streamIndex() != _video_index) {
+            const auto stamp { packet.pts() != AV_NOPTS_VALUE ? packet.pts() : packet.dts() };
+            if (::av_compare_ts(stamp, packet.timeBase(), end_abs, AV_TIME_BASE_Q) >= 0) {
+                finished_streams.insert(packet.streamIndex());
+            } else if (::av_compare_ts(stamp, packet.timeBase(), start_abs, AV_TIME_BASE_Q) >= 0) {
+                /* follows the offset of the video segments */
+                _joiner.shift(packet);
+                write(packet);
+            }
+            continue;
+        }
+
+        const auto keyframe_at {
+            [&packet](std::int64_t pts) { return packet.keyFrame() && (packet.pts() == pts); }
+        };
+        if ((phase == Phase::Head) && has_copy && keyframe_at(copy_begin)) {
+            encode_range(decoder.flush(time_base, _video_index), start_pts, head_end);
+            finish_edge();
+            _joiner.startSegment();
+            phase = Phase::Copy;
+        }
+        if ((phase == Phase::Copy) && keyframe_at(copy_end)) {
+            decoder.flushBuffers();
+            _joiner.startSegment();
+            phase = Phase::Tail;
+        }
+        switch (phase) {
+            case Phase::Head:
+                if (encode_range(decoder.decode(packet), start_pts, head_end) && !has_copy) {
+                    finish_edge();
+                    phase = Phase::Done;
+                }
+                break;
+            case Phase::Copy:
+                /* leading pictures of an open gop reference the gop
+                 * before copy_begin, which is re-encoded */
+                if ((packet.pts() != AV_NOPTS_VALUE) && (packet.pts() < copy_begin)) {
+                    break;
+                }
+                writeVideo(packet);
+                break;
+            case Phase::Tail:
+                if (encode_range(decoder.decode(packet), copy_end, end_pts)) {
+                    finish_edge();
+                    phase = Phase::Done;
+                }
+                break;
+            case Phase::Done:
+                break;
+        }
+        if (phase == Phase::Done) {
+            finished_streams.insert(_video_index);
+        }
+    }
+}
+
+void Trimmer::openSink(InputFormatContext& source) {
+    for (const auto& source_stream : source.streams()) {
+        _sink.copyStream(source_stream);
+    }
+    if (!_sink.open()) {
+        throw FFmpegException { "Failed to open " + utils::quoted(_sink.mediaResourceLocator()) };
+    }
+}
+
+void Trimmer::setOrigin(std::int64_t origin) {
+    for (const auto& sink_stream : _sink.streams()) {
+        sink_stream->setStampOffset(
+            -::av_rescale_q(origin, AV_TIME_BASE_Q, sink_stream->params->timeBase())
+        );
+    }
+}
+
+void Trimmer::write(Packet packet) {
+    if (!_sink.interleavedWrite(packet)) {
+        throw FFmpegException {
+            "Failed to write packet of stream #" + std::to_string(packet.streamIndex())
+            + " to " + utils::quoted(_sink.mediaResourceLocator())
+        };
+    }
+}
+
+void Trimmer::writeVideo(Packet packet) {
+    /* copied packets may start with dts behind the re-encoded head */
+    _joiner.shiftVideo(packet);
+    packet.setStreamIndex(_video_index);
+    write(packet);
+}
+
+void Trimmer::writeVideo(PacketVector packets) {
+    for (auto& packet : packets) {
+        writeVideo(packet);
+    }
+}
+
+std::unique_ptr<EncoderContext> Trimmer::createEdgeEncoder(const SpParameters& params) const {
+    const auto edge_params { VideoParameters::make_shared() };
+    edge_params->completeFrom(params);
+    /* parameter sets go to extradata only, the copied stream's are used */
+    edge_params->setFormatFlags(AVFMT_GLOBALHEADER);
+    /* no b-frames keeps edge dts equal to pts */
+    auto options { _encoder_options };
+    options.push_back({ "bf", "0" });
+    return std::make_unique<EncoderContext>(edge_params, options);
+}
+
+bool Trimmer::edgesMatchSource(const SpParameters& params) const {
+    if (params->codecId() != AV_CODEC_ID_H264) {
+        log_warning() << "Smart cut supports H.264 only";
+        return false;
+    }
+    const auto source_sets { h264_parameter_sets(params->extradata()) };
+    if (source_sets.empty()) {
+        log_warning() << "Source has no parameter sets in extradata";
+        return false;
+    }
+    const auto probe { createEdgeEncoder(params) };
+    return h264_parameter_sets(probe->params->extradata()) == source_sets;
+}
+
+PacketVector Trimmer::toSourceLayout(PacketVector packets) const {
+    if (_nal_length_size == 0) {
+        return packets;
+    }
+    for (auto& packet : packets) {
+        const auto data { packet.raw().data };
+        const auto size { std::size_t(packet.raw().size) };
+        if (!is_annexb(data, size)) {
+            continue;
+        }
+        std::vector<std::uint8_t> converted;
+        converted.reserve(size + 16);
+        for (const auto& [nal, nal_size] : split_annexb(data, size)) {
+            for (auto shift { 8 * (_nal_length_size - 1) }; shift >= 0; shift -= 8) {
+                converted.push_back(std::uint8_t(nal_size >> shift));
+            }
+            converted.insert(converted.end(), nal, nal + nal_size);
+        }
+        const auto buffer {
+            ::av_buffer_alloc(int(converted.size()) + AV_INPUT_BUFFER_PADDING_SIZE)
+        };
+        if (!buffer) {
+            throw std::bad_alloc {};
+        }
+        std::copy(converted.begin(), converted.end(), buffer->data);
+        std::fill_n(buffer->data + converted.size(), AV_INPUT_BUFFER_PADDING_SIZE, 0);
+        ::av_buffer_unref(&packet.raw().buf);
+        packet.raw().buf  = buffer;
+        packet.raw().data = buffer->data;
+        packet.raw().size = int(converted.size());
+    }
+    return packets;
+}
+
+} // namespace fpp
@@ -0,0 +1,73 @@
+#pragma once
+#include <fpp/format/InputFormatContext.hpp>
+#include <fpp/format/OutputFormatContext.hpp>
+#include <fpp/pipeline/SegmentJoiner.hpp>
+#include <memory>
+
+namespace fpp {
+
+class DecoderContext;
+class EncoderContext;
+
+/* Cuts [start, end) milliseconds out of a file without a full transcode.
+ * KeyframeSnap stream-copies whole gops starting at the keyframe
+ * preceding start. SmartCut copies the gops inside the range and
+ * decodes and re-encodes only the partial gops at the edges of the
+ * first video stream. Edges share the copied stream's extradata, so
+ * SmartCut needs H.264 and encoder options that reproduce the source's
+ * SPS/PPS, otherwise it falls back to KeyframeSnap */
+class Trimmer : public Object {
+
+public:
+
+    enum class Mode : std::uint8_t {
+          KeyframeSnap
+        , SmartCut
+    };
+
+    Trimmer(const std::string_view source_mrl
+          , OutputFormatContext& sink
+          , std::int64_t start
+          , std::int64_t end
+          , Mode mode = Mode::KeyframeSnap
+          , Options encoder_options = {});
+
+    void                trim();
+
+private:
+
+    enum class Phase : std::uint8_t {
+          Head  ///< re-encode from start to the first keyframe inside the range
+        , Copy  ///< stream-copy whole gops
+        , Tail  ///< re-encode from the last keyframe inside the range to end
+        , Done
+    };
+
+    void                snapCut(InputFormatContext& source);
+    void                smartCut(InputFormatContext& source);
+
+    void                openSink(InputFormatContext& source);
+    void                setOrigin(std::int64_t origin);
+    void                write(Packet packet);
+    void                writeVideo(Packet packet);
+    void                writeVideo(PacketVector packets);
+    std::unique_ptr<EncoderContext> createEdgeEncoder(const SpParameters& params) const;
+    bool                edgesMatchSource(const SpParameters& params) const;
+    PacketVector        toSourceLayout(PacketVector packets) const;
+
+private:
+
+    const std::string   _source_mrl;
+    OutputFormatContext& _sink;
+    const std::int64_t  _start;
+    const std::int64_t  _end;
+    const Mode          _mode;
+    const Options       _encoder_options;
+
+    int                 _video_index;
+    int                 _nal_length_size;   ///< avcC length prefix, 0 - Annex-B
+    SegmentJoiner       _joiner;            ///< edges and copied gops
+
+};
+
+} // namespace fpp
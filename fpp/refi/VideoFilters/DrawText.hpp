@@ -151,6 +151,28 @@ namespace fpp::VideoFilter::DrawText {
 
     };
 
-    std::string make(Text text, Font font = {}, Box box = {}, Shadow shadow = {}, Time time = {});
+    /* non-empty instance names the filter for the commands below */
+    std::string make(Text text, Font font = {}, Box box = {}, Shadow shadow = {}, Time time = {}
+                   , const std::string& instance = {});
+
+    /*
+     * Command for the running drawtext filter named instance in make,
+     * see FilterGraph::sendCommand and FilterGraph::queueCommand.
+     * Options not mentioned in arg keep their current values.
+     * reinit runs the filter's whole init again, font file loading
+     * included, so updates are not meant for every frame
+    */
+    struct Command {
+
+        std::string target;
+        std::string command { "reinit" };
+        std::string arg;
+
+    };
+
+    Command setText(const std::string& instance, const std::string& text);
+    Command setPosition(const std::string& instance, const std::string& x, const std::string& y);
+    /* every non-empty member is applied, defaults included */
+    Command setFont(const std::string& instance, Font font);
 
 } // namespace fpp::VideoFilter::DrawText
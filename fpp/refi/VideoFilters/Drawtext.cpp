@@ -2,10 +2,38 @@
 
 namespace fpp::VideoFilter::DrawText {
 
-    std::string make(Text text, Font font, Box box, Shadow shadow, Time time) {
+    namespace {
+
+        /* reinit's argument is parsed as an option string,
+         * so option delimiters inside values must be escaped */
+        std::string escape(const std::string& value) {
+            std::string escaped;
+            escaped.reserve(value.size());
+            for (const auto c : value) {
+                if ((c == ':') || (c == '\\') || (c == '\'')) {
+                    escaped.push_back('\\');
+                }
+                escaped.push_back(c);
+            }
+            return escaped;
+        }
+
+        void append(std::string& arg, const std::string& key, const std::string& value) {
+            if (value.empty()) {
+                return;
+            }
+            if (!arg.empty()) {
+                arg.push_back(':');
+            }
+            arg.append(key + '=' + escape(value));
+        }
+
+    } // namespace
+
+    std::string make(Text text, Font font, Box box, Shadow shadow, Time time, const std::string& instance) {
 
         std::string filter_description {
-            "drawtext="
+            instance.empty() ? "drawtext=" : "drawtext@" + instance + '='
         };
         const std::string param_delim { ": " };
         const auto create_param {
@@ -79,4 +107,32 @@ namespace fpp::VideoFilter::DrawText {
 
     }
 
+    Command setText(const std::string& instance, const std::string& text) {
+        Command cmd;
+        cmd.target = instance;
+        cmd.arg = "text=" + escape(text);
+        return cmd;
+    }
+
+    Command setPosition(const std::string& instance, const std::string& x, const std::string& y) {
+        Command cmd;
+        cmd.target = instance;
+        append(cmd.arg, "x", x);
+        append(cmd.arg, "y", y);
+        return cmd;
+    }
+
+    Command setFont(const std::string& instance, Font font) {
+        Command cmd;
+        cmd.target = instance;
+        append(cmd.arg, "font",             font.font);
+        append(cmd.arg, "fontfile",         font.fontfile);
+        append(cmd.arg, "fontsize",         font.fontsize);
+        append(cmd.arg, "fontcolor",        font.fontcolor);
+        append(cmd.arg, "fontcolor_expr",   font.fontcolor_expr);
+        append(cmd.arg, "alpha",            font.alpha);
+        append(cmd.arg, "ft_load_flags",    font.ft_load_flags);
+        return cmd;
+    }
+
 } // namespace fpp::VideoFilter::DrawText
@@ -0,0 +1,208 @@
+#include "AudioFifo.hpp"
+#include <fpp/core/FFmpegException.hpp>
+#include <fpp/core/Utils.hpp>
+#include <fpp/core/AllocationTracker.hpp>
+
+extern "C" {
+    #include <libavutil/audio_fifo.h>
+    #include <libavutil/samplefmt.h>
+    #include <libavutil/buffer.h>
+}
+
+namespace fpp {
+
+    AudioFifo::AudioFifo(InOutParams parameters)
+        : params { parameters }
+        , _buffer_size { 0 }
+        , _samples_count { 0 }
+        , _source_pts { NOPTS_VALUE }
+        , _time_base { DEFAULT_RATIONAL }
+        , _stream_index { -1 } {
+        init();
+    }
+
+    FrameVector AudioFifo::push(const Frame& frame) {
+        FPP_ALLOCATION_SCOPE(Resample);
+        const auto out_param {
+            std::static_pointer_cast<const AudioParameters>(params.out)
+        };
+
+        if (_source_pts == NOPTS_VALUE) {
+            _source_pts = frame.pts();
+        }
+        _time_base = frame.timeBase();
+        _stream_index = frame.streamIndex();
+
+        /* Frame already has the encoder's size and nothing is buffered,
+         * or the encoder takes any size (pcm): pass it through
+         * without copying a single sample. */
+        if (variableFrameSize()
+                || ((size() == 0) && (frame.nbSamples() == out_param->frameSize()))) {
+            Frame passed { frame };
+            stampFrame(passed);
+            return { passed };
+        }
+
+        if (const auto ret {
+                ::av_audio_fifo_write(
+                    raw()
+                    , reinterpret_cast<void**>(frame.ptr()->extended_data)
+                    , frame.nbSamples()
+                )
+            }; ret < frame.nbSamples()) {
+            throw FFmpegException {
+                "av_audio_fifo_write failed: " + std::to_string(ret)
+            };
+        }
+        return receiveFrames(out_param->frameSize());
+    }
+
+    FrameVector AudioFifo::flush() {
+        /* The tail is emitted as one shorter frame. */
+        return receiveFrames(1);
+    }
+
+    int AudioFifo::size() const {
+        if (variableFrameSize()) {
+            return 0;
+        }
+        return ::av_audio_fifo_size(const_cast<AVAudioFifo*>(raw()));
+    }
+
+    bool AudioFifo::variableFrameSize() const {
+        return std::static_pointer_cast<const AudioParameters>(params.out)->frameSize() <= 0;
+    }
+
+    void AudioFifo::init() {
+        const auto out_param {
+            std::static_pointer_cast<const AudioParameters>(params.out)
+        };
+
+        if (variableFrameSize()) {
+            log_info() << "Inited: variable frame size, frames pass through";
+            return;
+        }
+
+        reset(
+            ::av_audio_fifo_alloc(
+                out_param->sampleFormat()
+                , int(out_param->channels())
+                , out_param->frameSize() * 2
+            )
+            , [](auto* fifo) { ::av_audio_fifo_free(fifo); }
+        );
+        if (!raw()) {
+            throw FFmpegException { "av_audio_fifo_alloc failed" };
+        }
+
+        _buffer_size = ::av_samples_get_buffer_size(
+            nullptr
+            , int(out_param->channels())
+            , out_param->frameSize()
+            , out_param->sampleFormat()
+            , 0 /* align */
+        );
+        if (_buffer_size < 0) {
+            throw FFmpegException {
+                "av_samples_get_buffer_size failed: " + std::to_string(_buffer_size)
+            };
+        }
+        _pool.reset(
+            ::av_buffer_pool_init(_buffer_size, nullptr)
+            , [](auto* pool) { ::av_buffer_pool_uninit(&pool); }
+        );
+
+        log_info() << "Inited: "
+            << out_param->sampleFormat()
+            << ", channels " << out_param->channels()
+            << ", nb_smp " << out_param->frameSize();
+    }
+
+    Frame AudioFifo::createFrame(int nb_samples) const {
+        Frame frame { params.out->type() };
+        const auto out_param {
+            std::static_pointer_cast<const AudioParameters>(params.out)
+        };
+        frame.raw().nb_samples     = nb_samples;
+        frame.raw().channel_layout = out_param->channelLayout();
+        frame.raw().channels       = int(out_param->channels());
+        frame.raw().format         = out_param->sampleFormat();
+        frame.raw().sample_rate    = out_param->sampleRate();
+
+        /* Planes that do not fit into AVFrame::data need extended_data,
+         * leave that case to av_frame_get_buffer. */
+        if (out_param->channels() > AV_NUM_DATA_POINTERS) {
+            ffmpeg_api_strict(av_frame_get_buffer, frame.ptr(), 0);
+            FPP_COUNT_BUFFER_ALLOCATION();
+            return frame;
+        }
+
+        /* Buffers are recycled by the pool once the encoder
+         * releases the frame, no allocation in the steady state. */
+        frame.raw().buf[0] = ::av_buffer_pool_get(_pool.get());
+        if (!frame.raw().buf[0]) {
+            throw FFmpegException { "av_buffer_pool_get failed" };
+        }
+        ffmpeg_api_strict(av_samples_fill_arrays
+            , frame.raw().data
+            , frame.raw().linesize
+            , frame.raw().buf[0]->data
+            , int(out_param->channels())
+            , nb_samples
+            , out_param->sampleFormat()
+            , 0 /* align */
+        );
+        frame.raw().extended_data = frame.raw().data;
+        return frame;
+    }
+
+    FrameVector AudioFifo::receiveFrames(int min_samples) {
+        const auto out_param {
+            std::static_pointer_cast<const AudioParameters>(params.out)
+        };
+
+        FrameVector frames;
+        while (size() >= min_samples && size() > 0) {
+            const auto nb_samples { std::min(size(), out_param->frameSize()) };
+            Frame frame { createFrame(nb_samples) };
+            if (const auto ret {
+                    ::av_audio_fifo_read(
+                        raw()
+                        , reinterpret_cast<void**>(frame.raw().extended_data)
+                        , nb_samples
+                    )
+                }; ret < nb_samples) {
+                throw FFmpegException {
+                    "av_audio_fifo_read failed: " + std::to_string(ret)
+                };
+            }
+            stampFrame(frame);
+            frame.setTimeBase(_time_base);
+            frame.setStreamIndex(_stream_index);
+            frames.push_back(frame);
+        }
+        return frames;
+    }
+
+    void AudioFifo::stampFrame(Frame& frame) {
+        /* Same timeline as ResampleContext::stampFrame without
+         * sync correction: samples counted from zero. */
+        if (_source_pts != NOPTS_VALUE) {
+            const auto in_param {
+                std::static_pointer_cast<const AudioParameters>(params.in)
+            };
+            const auto out_param {
+                std::static_pointer_cast<const AudioParameters>(params.out)
+            };
+            const auto samples_time_base { ::av_make_q(1, int(out_param->sampleRate())) };
+            if (!_stamp_rescaler.converts(samples_time_base, in_param->timeBase())) {
+                _stamp_rescaler = Rescaler { samples_time_base, in_param->timeBase() };
+            }
+            frame.setPts(_stamp_rescaler(_samples_count));
+        } else {
+            frame.setPts(NOPTS_VALUE);
+        }
+        _samples_count += frame.nbSamples();
+    }
+
+} // namespace fpp
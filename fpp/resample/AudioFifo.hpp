@@ -0,0 +1,50 @@
+#pragma once
+#include <fpp/core/wrap/SharedFFmpegObject.hpp>
+#include <fpp/stream/AudioParameters.hpp>
+#include <fpp/base/Frame.hpp>
+#include <fpp/core/time/Rescaler.hpp>
+
+struct AVAudioFifo;
+struct AVBufferPool;
+
+namespace fpp {
+
+    /* Re-chunks audio frames to the frame size of the output
+     * parameters without any sample conversion. Used instead of
+     * ResampleContext when utils::resampling_required is false:
+     * samples are copied once into the fifo and once into a pooled
+     * output buffer, frames of the right size pass through as is. */
+    class AudioFifo : public SharedFFmpegObject<AVAudioFifo> {
+
+    public:
+
+        explicit AudioFifo(InOutParams parameters);
+
+        FrameVector         push(const Frame& frame);
+        FrameVector         flush();
+
+        int                 size() const;
+
+        const InOutParams   params;
+
+    private:
+
+        void                init();
+        bool                variableFrameSize() const;
+        Frame               createFrame(int nb_samples) const;
+        FrameVector         receiveFrames(int min_samples);
+        void                stampFrame(Frame& frame);
+
+    private:
+
+        std::shared_ptr<AVBufferPool> _pool;
+        int                 _buffer_size;
+        std::int64_t        _samples_count;
+        std::int64_t        _source_pts;
+        AVRational          _time_base;
+        int                 _stream_index;
+        Rescaler            _stamp_rescaler;    ///< output samples -> input time base
+
+    };
+
+} // namespace fpp
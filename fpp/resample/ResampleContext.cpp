@@ -1,25 +1,80 @@
 #include "ResampleContext.hpp"
 #include <fpp/core/FFmpegException.hpp>
 #include <fpp/core/Utils.hpp>
+#include <fpp/core/AllocationTracker.hpp>
+#include <algorithm>
 
 extern "C" {
     #include <libswresample/swresample.h>
+    #include <libavutil/opt.h>
 }
 
 namespace fpp {
 
     ResampleContext::ResampleContext(InOutParams parameters)
+        : ResampleContext(parameters, AudioSyncCorrection {}) {
+    }
+
+    ResampleContext::ResampleContext(InOutParams parameters, const AudioSyncCorrection& sync)
         : params { parameters }
         , _samples_count { 0 }
-        , _source_pts { 0 } {
+        , _source_pts { 0 }
+        , _sync { sync }
+        , _first_pts { NOPTS_VALUE }
+        , _drift { 0 }
+        , _compensation { 0 } {
         init();
     }
 
+    const AudioSyncCorrection& ResampleContext::syncCorrection() const {
+        return _sync;
+    }
+
+    std::int64_t ResampleContext::drift() const {
+        return _drift;
+    }
+
     FrameVector ResampleContext::resample(const Frame& frame) {
+        if (_fifo) {
+            return _fifo->push(frame);
+        }
+        FPP_ALLOCATION_SCOPE(Resample);
         sendFrame(frame);
         return receiveFrames(frame.timeBase(), frame.streamIndex());
     }
 
+    FrameVector ResampleContext::flush(AVRational time_base, int stream_index) {
+        if (_fifo) {
+            return _fifo->flush();
+        }
+        FrameVector flushed_frames { receiveFrames(time_base, stream_index) };
+        /* swr_convert_frame without input drains the delay buffer
+         * and sets nb_samples to what it actually wrote */
+        while (::swr_get_out_samples(raw(), 0) > 0) {
+            Frame frame { createFrame() };
+            if (const auto ret {
+                ::swr_convert_frame(
+                    raw()         /* swr    */
+                    , frame.ptr() /* output */
+                    , nullptr     /* input  */
+                )
+            }; ret < 0) {
+                throw FFmpegException {
+                    "swr_convert_frame failed: "
+                        + utils::swr_convert_frame_error_to_string(ret)
+                };
+            }
+            if (frame.nbSamples() == 0) {
+                break;
+            }
+            stampFrame(frame);
+            frame.setTimeBase(time_base);
+            frame.setStreamIndex(stream_index);
+            flushed_frames.push_back(frame);
+        }
+        return flushed_frames;
+    }
+
     void ResampleContext::init() {
         const auto in_param {
             std::static_pointer_cast<const AudioParameters>(params.in)
@@ -28,6 +83,15 @@ namespace fpp {
             std::static_pointer_cast<const AudioParameters>(params.out)
         };
 
+        /* Same rate, format and layout: only the frame size can differ,
+         * which does not need swresample at all. Drift correction
+         * changes the sample count, so it always goes through swr. */
+        if (!_sync.enabled && !utils::resampling_required(params)) {
+            _fifo = std::make_unique<AudioFifo>(params);
+            log_info() << "Resampling not required, re-chunking through audio fifo";
+            return;
+        }
+
         reset(
             ::swr_alloc_set_opts(
                 nullptr   /* existing Swr context */
@@ -43,6 +107,11 @@ namespace fpp {
             , [](auto* ctx) { ::swr_free(&ctx); }
         );
 
+        /* Compensation needs the resampler even at equal rates,
+         * swr_set_compensation fails on a plain converter. */
+        if (_sync.enabled) {
+            ffmpeg_api_strict(av_opt_set_int, raw(), "flags", SWR_FLAG_RESAMPLE, 0);
+        }
         ffmpeg_api_strict(swr_init, raw());
 
         log_info() << "Inited "
@@ -84,10 +153,14 @@ namespace fpp {
          * sure that the audio frame can hold as many samples as specified. */
         constexpr auto align { 32 };
         ffmpeg_api_strict(av_frame_get_buffer, frame.ptr(), align);
+        FPP_COUNT_BUFFER_ALLOCATION();
         return frame;
     }
 
     void ResampleContext::sendFrame(const Frame& frame) {
+        if (_sync.enabled && (frame.pts() != NOPTS_VALUE)) {
+            correctDrift(frame);
+        }
         if (const auto ret {
                 ::swr_convert_frame(
                     raw()         /* swr    */
@@ -139,13 +212,16 @@ namespace fpp {
                 std::static_pointer_cast<const AudioParameters>(params.out)
             };
 
-            const auto out_pts {
-                ::av_rescale_q(
-                    _samples_count
-                    , ::av_make_q(1, int(out_param->sampleRate()))
-                    , in_param->timeBase()
-                )
+            /* Corrected output follows the source clock,
+             * so it is stamped relative to the first source pts. */
+            const auto origin {
+                (_sync.enabled && (_first_pts != NOPTS_VALUE)) ? _first_pts : 0
             };
+            const auto samples_time_base { ::av_make_q(1, int(out_param->sampleRate())) };
+            if (!_stamp_rescaler.converts(samples_time_base, in_param->timeBase())) {
+                _stamp_rescaler = Rescaler { samples_time_base, in_param->timeBase() };
+            }
+            const auto out_pts { origin + _stamp_rescaler(_samples_count) };
             frame.setPts(out_pts);
         } else {
             frame.setPts(NOPTS_VALUE);
@@ -153,4 +229,68 @@ namespace fpp {
         _samples_count += frame.nbSamples();
     }
 
+    void ResampleContext::correctDrift(const Frame& frame) {
+        if (_first_pts == NOPTS_VALUE) {
+            _first_pts = frame.pts();
+            return;
+        }
+
+        const auto out_param {
+            std::static_pointer_cast<const AudioParameters>(params.out)
+        };
+        const auto out_rate { out_param->sampleRate() };
+        const auto ms_to_samples {
+            [out_rate](std::int64_t ms) {
+                return ::av_rescale(ms, out_rate, 1000);
+            }
+        };
+
+        /* Where the frame should start on the output timeline
+         * against where the already produced and buffered samples end,
+         * both in output samples. */
+        if (const auto samples_time_base { ::av_make_q(1, int(out_rate)) };
+                !_drift_rescaler.converts(frame.timeBase(), samples_time_base)) {
+            _drift_rescaler = Rescaler { frame.timeBase(), samples_time_base };
+        }
+        const auto position { _drift_rescaler(frame.pts() - _first_pts) };
+        const auto expected { _samples_count + ::swr_get_delay(raw(), out_rate) };
+        _drift = position - expected;
+
+        const auto abs_drift { std::abs(_drift) };
+        if (abs_drift >= ms_to_samples(_sync.hard_drift)) {
+            if (_drift > 0) {
+                log_warning() << "Audio is behind the source clock by "
+                              << _drift << " samples, injecting silence";
+                ffmpeg_api_strict(swr_inject_silence, raw(), int(_drift));
+            }
+            else {
+                log_warning() << "Audio is ahead of the source clock by "
+                              << -_drift << " samples, dropping output";
+                ffmpeg_api_strict(swr_drop_output, raw(), int(-_drift));
+            }
+            /* Both take effect on the next swr_convert_frame call
+             * in receiveFrames, before the next drift measurement. */
+            return;
+        }
+        if (abs_drift >= ms_to_samples(_sync.min_drift)) {
+            const auto distance { ms_to_samples(_sync.window) };
+            const auto max_delta {
+                std::max(std::int64_t(double(distance) * _sync.max_stretch), std::int64_t { 1 })
+            };
+            setCompensation(std::clamp(_drift, -max_delta, max_delta), distance);
+        }
+        else {
+            setCompensation(0, 0);
+        }
+    }
+
+    void ResampleContext::setCompensation(std::int64_t delta, std::int64_t distance) {
+        /* swr restarts the compensation on every call */
+        if (delta == _compensation) {
+            return;
+        }
+        ffmpeg_api_strict(swr_set_compensation, raw(), int(delta), int(distance));
+        _compensation = delta;
+    }
+
 } // namespace fpp
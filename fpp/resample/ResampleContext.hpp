@@ -2,18 +2,40 @@
 #include <fpp/core/wrap/SharedFFmpegObject.hpp>
 #include <fpp/stream/AudioParameters.hpp>
 #include <fpp/base/Frame.hpp>
+#include <fpp/resample/AudioFifo.hpp>
+#include <fpp/core/time/Rescaler.hpp>
+#include <memory>
 
 struct SwrContext;
 
 namespace fpp {
 
+    /* Keeps the resampled audio aligned to the incoming pts,
+     * small drift is absorbed by stretching or squeezing the
+     * output, large gaps are filled with silence or dropped. */
+    struct AudioSyncCorrection {
+
+        bool                enabled         { false };
+        std::int64_t        min_drift       { 2 };      ///< ms, drift ignored below
+        std::int64_t        hard_drift      { 100 };    ///< ms, silence/drop above
+        std::int64_t        window          { 1000 };   ///< ms, compensation distance
+        double              max_stretch     { 0.001 };  ///< max fraction of the window
+
+    };
+
     class ResampleContext : public SharedFFmpegObject<SwrContext> {
 
     public:
 
         explicit ResampleContext(InOutParams parameters);
+        ResampleContext(InOutParams parameters, const AudioSyncCorrection& sync);
 
         FrameVector         resample(const Frame& frame);
+        /* returns the buffered samples, the last frame may be short */
+        FrameVector         flush(AVRational time_base, int stream_index);
+
+        const AudioSyncCorrection& syncCorrection() const;
+        std::int64_t        drift() const;
 
         const InOutParams   params;
 
@@ -24,11 +46,20 @@ namespace fpp {
         void                sendFrame(const Frame& frame);
         FrameVector         receiveFrames(AVRational time_base, int stream_index);
         void                stampFrame(Frame& frame);
+        void                correctDrift(const Frame& frame);
+        void                setCompensation(std::int64_t delta, std::int64_t distance);
 
     private:
 
         std::int64_t        _samples_count;
         std::int64_t        _source_pts;
+        std::unique_ptr<AudioFifo> _fifo;
+        AudioSyncCorrection _sync;
+        std::int64_t        _first_pts;
+        std::int64_t        _drift;
+        std::int64_t        _compensation;      ///< samples, last set delta
+        Rescaler            _stamp_rescaler;    ///< output samples -> input time base
+        Rescaler            _drift_rescaler;    ///< frame time base -> output samples
 
     };
 
@@ -1,9 +1,12 @@
 #include "RescaleContext.hpp"
 #include <fpp/core/FFmpegException.hpp>
 #include <fpp/core/Utils.hpp>
+#include <fpp/core/AllocationTracker.hpp>
 
 extern "C" {
     #include <libswscale/swscale.h>
+    #include <libavutil/imgutils.h>
+    #include <libavutil/pixdesc.h>
 }
 
 namespace fpp {
@@ -14,6 +17,7 @@ namespace fpp {
     }
 
     Frame RescaleContext::scale(const Frame& frame) {
+        FPP_ALLOCATION_SCOPE(Rescale);
         Frame rescaled_frame { createFrame() };
         ::sws_scale(
               raw()
@@ -27,9 +31,45 @@ namespace fpp {
         ::av_frame_copy_props(rescaled_frame.ptr(), frame.ptr());
         rescaled_frame.setTimeBase(frame.timeBase());
         rescaled_frame.setStreamIndex(frame.streamIndex());
+        if (auto trace { rescaled_frame.trace() }; !trace.empty()) {
+            trace.mark(Trace::Hop::Rescale);
+            rescaled_frame.setTrace(trace);
+        }
         return rescaled_frame;
     }
 
+    void RescaleContext::scaleInto(const Frame& frame, Frame& target, int x, int y) {
+        FPP_ALLOCATION_SCOPE(Rescale);
+        const auto pix_fmt { AVPixelFormat(target.raw().format) };
+        const auto desc { ::av_pix_fmt_desc_get(pix_fmt) };
+        if (!desc || (desc->flags & AV_PIX_FMT_FLAG_PAL)) {
+            throw FFmpegException {
+                "Cannot scale into a region of " + utils::to_string(pix_fmt)
+            };
+        }
+        /* byte offset of x in every plane is the line size of x pixels */
+        int x_offsets[4] {};
+        ffmpeg_api_strict(av_image_fill_linesizes, x_offsets, pix_fmt, x);
+
+        std::uint8_t* dst[4] {};
+        for (auto plane { 0 }; plane < ::av_pix_fmt_count_planes(pix_fmt); ++plane) {
+            const auto chroma { (plane == 1) || (plane == 2) };
+            const auto row { chroma ? AV_CEIL_RSHIFT(y, desc->log2_chroma_h) : y };
+            dst[plane] = target.raw().data[plane]
+                       + std::ptrdiff_t(row) * target.raw().linesize[plane]
+                       + x_offsets[plane];
+        }
+        ::sws_scale(
+              raw()
+            , frame.raw().data              /* srcSlice[]  */
+            , frame.raw().linesize          /* srcStride[] */
+            , 0                             /* srcSliceY   */
+            , frame.raw().height            /* srcSliceH   */
+            , dst                           /* dst[]       */
+            , target.raw().linesize         /* dstStride[] */
+        );
+    }
+
     void RescaleContext::init() {
         const auto in_param {
             std::static_pointer_cast<const VideoParameters>(params.in)
@@ -73,6 +113,7 @@ namespace fpp {
         frame.raw().height = output_params->height();
         constexpr auto align { 32 };
         ffmpeg_api_strict(av_frame_get_buffer, frame.ptr(), align);
+        FPP_COUNT_BUFFER_ALLOCATION();
         return frame;
     }
 
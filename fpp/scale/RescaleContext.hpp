@@ -14,6 +14,10 @@ namespace fpp {
         explicit RescaleContext(InOutParams parameters);
 
         Frame               scale(const Frame& frame);
+        /* scales into the region of target starting at (x, y),
+         * target has the output pixel format and is large enough;
+         * x and y must be multiples of the chroma subsampling */
+        void                scaleInto(const Frame& frame, Frame& target, int x, int y);
 
         const InOutParams   params;
 
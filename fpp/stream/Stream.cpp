@@ -17,7 +17,9 @@ namespace fpp {
         , _packet_index { 0 }
         , _start_time_point { FROM_START }
         , _end_time_point { TO_END }
-        , _stamp_from_zero { false } {
+        , _stamp_from_zero { false }
+        , _stamp_offset { 0 }
+        , _end_stamp { NOPTS_VALUE } {
         if (duration() == NOPTS_VALUE) {
             setDuration(0);
         }
@@ -55,11 +57,10 @@ namespace fpp {
 
     void Stream::stampPacket(Packet& packet) {
         if (packet.timeBase() != DEFAULT_RATIONAL) {
-            ::av_packet_rescale_ts(
-                packet.ptr()
-                , packet.timeBase()
-                , params->timeBase()
-            );
+            if (!_packet_rescaler.converts(packet.timeBase(), params->timeBase())) {
+                _packet_rescaler = Rescaler { packet.timeBase(), params->timeBase() };
+            }
+            _packet_rescaler.rescale(packet.ptr());
         }
 
         if (_stamp_from_zero) {
@@ -68,6 +69,10 @@ namespace fpp {
             // TODO: fix duration in MediaInfo (15.04)
         }
 
+        if (_stamp_offset != 0) {
+            applyStampOffset(packet);
+        }
+
         if (packet.duration() == 0) {
             calculatePacketDuration(packet);
         }
@@ -80,21 +85,36 @@ namespace fpp {
         packet.setTimeBase(params->timeBase());
 
         increaseDuration(packet.duration());
+        updateEndStamp(packet);
         _prev_dts = packet.dts();
         _prev_pts = packet.pts();
         _packet_index++;
     }
 
     bool Stream::timeIsOver() const {
+        /* a stream with a start point is seeked, the lead-in up to
+         * the keyframe would be counted by the accumulated duration,
+         * so the position of the last packet is compared instead */
+        if ((_start_time_point != FROM_START) && (_prev_pts != NOPTS_VALUE)) {
+            const auto origin {
+                (_stamp_from_zero || (raw()->start_time == NOPTS_VALUE)) ? 0 : raw()->start_time
+            };
+            const auto position {
+                toMilliseconds(_prev_pts - _stamp_offset - origin)
+            };
+            if (position >= _end_time_point) {
+                log_info()
+                    << "End time point reached: "
+                    << utils::time_to_string(position, DEFAULT_TIME_BASE);
+                return true;
+            }
+            return false;
+        }
         const auto planned_duration {
             _end_time_point - _start_time_point
         };
         const auto actual_duration {
-            ::av_rescale_q(
-                duration()
-                , params->timeBase()
-                , DEFAULT_TIME_BASE
-            )
+            toMilliseconds(duration())
         };
         if (actual_duration >= planned_duration) {
             log_info()
@@ -113,7 +133,7 @@ namespace fpp {
         raw()->duration = duration;
     }
 
-    void Stream::setStartTimePoint(std::int64_t msec) { // TODO (18.05)
+    void Stream::setStartTimePoint(std::int64_t msec) {
         if (_start_time_point == msec) {
             return;
         }
@@ -130,7 +150,7 @@ namespace fpp {
     }
 
     // TODO: use setEndTimePoint for context. do not specify "source.stream(0)->setEndTimePoint(one_minute);"
-    void Stream::setEndTimePoint(std::int64_t msec) { // TODO (18.05)
+    void Stream::setEndTimePoint(std::int64_t msec) {
         if (_end_time_point == msec) {
             return;
         }
@@ -150,6 +170,10 @@ namespace fpp {
         _stamp_from_zero = value;
     }
 
+    void Stream::setStampOffset(std::int64_t offset) {
+        _stamp_offset = offset;
+    }
+
     int Stream::index() const {
         return raw()->index;
     }
@@ -170,6 +194,14 @@ namespace fpp {
         return _packet_index;
     }
 
+    std::int64_t Stream::stampOffset() const {
+        return _stamp_offset;
+    }
+
+    std::int64_t Stream::endStamp() const {
+        return _end_stamp;
+    }
+
     AVCodecParameters* Stream::codecpar() {
         if (!raw()) {
             throw std::runtime_error { "stream is null" };
@@ -198,6 +230,27 @@ namespace fpp {
         }
     }
 
+    void Stream::applyStampOffset(Packet& packet) {
+        if (packet.dts() != NOPTS_VALUE) {
+            packet.setDts(packet.dts() + _stamp_offset);
+        }
+        if (packet.pts() != NOPTS_VALUE) {
+            packet.setPts(packet.pts() + _stamp_offset);
+        }
+    }
+
+    void Stream::updateEndStamp(const Packet& packet) {
+        const auto stamp {
+            packet.pts() != NOPTS_VALUE ? packet.pts() : packet.dts()
+        };
+        if (stamp == NOPTS_VALUE) {
+            return;
+        }
+        if ((_end_stamp == NOPTS_VALUE) || (stamp + packet.duration() > _end_stamp)) {
+            _end_stamp = stamp + packet.duration();
+        }
+    }
+
     void Stream::calculatePacketDuration(Packet& packet) {
         if (raw()->cur_dts == NOPTS_VALUE) {
             packet.setDuration(0);
@@ -206,6 +259,13 @@ namespace fpp {
         }
     }
 
+    std::int64_t Stream::toMilliseconds(std::int64_t stamp) const {
+        if (!_time_rescaler.converts(params->timeBase(), DEFAULT_TIME_BASE)) {
+            _time_rescaler = Rescaler { params->timeBase(), DEFAULT_TIME_BASE };
+        }
+        return _time_rescaler(stamp);
+    }
+
 //    void Stream::avoidNegativeTimestamp(Packet& packet) {
 //        if (packet.dts() < 0) {
 //            packet.setDts(0);
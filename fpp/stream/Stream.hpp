@@ -1,6 +1,7 @@
 #pragma once
 #include <fpp/base/Parameters.hpp>
 #include <fpp/base/Packet.hpp>
+#include <fpp/core/time/Rescaler.hpp>
 #include <vector>
 
 constexpr auto FROM_START { 0ll       };
@@ -33,12 +34,15 @@ namespace fpp {
         void                setEndTimePoint(std::int64_t msec);
 
         void                stampFromZero(bool value);
+        void                setStampOffset(std::int64_t offset);
 
         int                 index()             const;
         std::int64_t        duration()          const;
         std::int64_t        startTimePoint()    const;
         std::int64_t        endTimePoint()      const;
         std::int64_t        packetIndex()       const;
+        std::int64_t        stampOffset()       const;
+        std::int64_t        endStamp()          const;
 
         AVCodecParameters*  codecpar();
 
@@ -49,7 +53,10 @@ namespace fpp {
         void                increaseDuration(const std::int64_t value);
 
         void                shiftStamps(Packet& packet);
+        void                applyStampOffset(Packet& packet);
+        void                updateEndStamp(const Packet& packet);
         void                calculatePacketDuration(Packet& packet);
+        std::int64_t        toMilliseconds(std::int64_t stamp) const;
 //        void                avoidNegativeTimestamp(Packet& packet);
 //        void                checkStampMonotonicity(Packet& packet);
 //        void                checkDtsPtsOrder(Packet& packet);
@@ -64,10 +71,15 @@ namespace fpp {
         std::int64_t        _prev_pts;
         std::int64_t        _packet_index;
 
-        std::int64_t        _start_time_point; // TODO not used 25.03
+        std::int64_t        _start_time_point;
         std::int64_t        _end_time_point;
 
         bool                _stamp_from_zero;
+        std::int64_t        _stamp_offset;      // added to stamps, stream time base
+        std::int64_t        _end_stamp;         // max pts + duration of stamped packets
+
+        Rescaler            _packet_rescaler;   // packet time base -> stream time base
+        mutable Rescaler    _time_rescaler;     // stream time base -> ms
 
     public:
 
@@ -43,6 +43,13 @@ auto main() -> int {
 //        concatenate();
 //        multiple_outputs_sequence();
 //        multiple_outputs_parallel();
+//        thumbnails();
+//        segment_transcoding();
+//        trimming();
+//        keyframe_preview();
+//        audio_mix();
+//        mosaic();
+//        remuxing();
 
     } catch (const fpp::FFmpegException& e) {
         fpp::static_log_error() << "FFmpegException:" << e.what();